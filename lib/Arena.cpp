@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "utils.hpp"
+
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace memory {
+
+Arena::Arena(Heap& heap, std::size_t blockSize) noexcept
+    : m_heap(&heap)
+    , m_blockSize(blockSize)
+{}
+
+Arena::~Arena()
+{
+    reset();
+}
+
+void Arena::rewind(const Marker& marker)
+{
+    while (m_block != nullptr && m_block != marker.block) {
+        auto* prev = m_block->prev;
+        m_heap->release(m_block);
+        m_block = prev;
+    }
+
+    m_cursor = marker.cursor;
+    m_end = (m_block != nullptr) ? std::uintptr_t(m_block) + m_block->size : 0;
+}
+
+void Arena::reset()
+{
+    rewind({nullptr, 0});
+}
+
+std::size_t Arena::blocksCount() const
+{
+    std::size_t count = 0;
+    for (auto* block = m_block; block != nullptr; block = block->prev)
+        ++count;
+
+    return count;
+}
+
+void* Arena::allocateBlock(std::size_t size, std::size_t alignment)
+{
+    assert(utils::isPowerOf2(alignment));
+
+    auto pageSize = m_heap->pageSize();
+    if (size == 0 || pageSize == 0)
+        return nullptr;
+
+    auto requiredSize = sizeof(Block) + size + alignment - 1;
+    if (requiredSize < size)
+        return nullptr;
+
+    auto blockSize = utils::roundUp(std::max(m_blockSize, requiredSize), pageSize);
+
+    auto* block = static_cast<Block*>(m_heap->allocate(blockSize));
+    if (block == nullptr)
+        return nullptr;
+
+    block->prev = m_block;
+    block->size = blockSize;
+
+    m_block = block;
+    m_cursor = std::uintptr_t(block) + sizeof(Block);
+    m_end = std::uintptr_t(block) + blockSize;
+    return allocate(size, alignment);
+}
+
+} // namespace memory
@@ -0,0 +1,301 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Cache.hpp"
+
+#include "Page.hpp"
+#include "PageAllocator.hpp"
+#include "ZoneAllocator.hpp"
+#include "utils.hpp"
+
+#include <allocator/config.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace memory {
+
+bool Cache::init(PageAllocator* pageAllocator,
+                 ZoneAllocator* zoneAllocator,
+                 std::size_t pageSize,
+                 const char* name,
+                 std::size_t size,
+                 std::size_t alignment,
+                 const CacheHooks& hooks)
+{
+    if (!clear())
+        return false;
+
+    if (pageAllocator == nullptr || zoneAllocator == nullptr || pageSize <= sizeof(Zone))
+        return false;
+
+    if (size == 0 || size > pageSize || !utils::isPowerOf2(alignment) || alignment > pageSize)
+        return false;
+
+    // Constructed objects cannot be overwritten by the free list, so it is kept in front of them.
+    bool constructed = (hooks.init != nullptr || hooks.fini != nullptr);
+    std::size_t objectOffset = constructed ? utils::roundUp(sizeof(Chunk), alignment) : 0;
+    std::size_t chunkAlignment = std::max(alignment, alignof(Chunk));
+    std::size_t chunkSize = utils::roundUp(std::max(objectOffset + size, sizeof(Chunk)), chunkAlignment);
+    std::size_t zoneSize = pageSize - sizeof(Zone);
+    if (chunkSize > zoneSize)
+        return false;
+
+    // Slack left after the last chunk is used to shift the first chunk of consecutive zones by whole cache lines.
+    std::size_t slack = zoneSize % chunkSize;
+    std::size_t colorStep = std::max(config::cCacheLineSize, chunkAlignment);
+
+    m_pageAllocator = pageAllocator;
+    m_zoneAllocator = zoneAllocator;
+    m_pageSize = pageSize;
+    m_name = name;
+    m_objectSize = size;
+    m_objectOffset = objectOffset;
+    m_chunkSize = chunkSize;
+    m_colorStep = colorStep;
+    m_colorsCount = slack / colorStep + 1;
+    m_hooks = hooks;
+    m_zoneAllocator->addCache(this);
+    return true;
+}
+
+bool Cache::clear()
+{
+    // Releasing zones with allocated objects would leave them pointing into pages handed out again.
+    if (m_fullZones != nullptr || zonesCount() != m_emptyZonesCount)
+        return false;
+
+    while (m_partialZones != nullptr)
+        releaseZone(m_partialZones);
+
+    if (m_zoneAllocator != nullptr)
+        m_zoneAllocator->removeCache(this);
+
+    m_pageAllocator = nullptr;
+    m_zoneAllocator = nullptr;
+    m_pageSize = 0;
+    m_name = nullptr;
+    m_objectSize = 0;
+    m_objectOffset = 0;
+    m_chunkSize = 0;
+    m_colorStep = 0;
+    m_colorsCount = 0;
+    m_nextColor = 0;
+    m_hooks = {};
+    m_emptyZonesCount = 0;
+    return true;
+}
+
+void* Cache::allocate()
+{
+    if (m_partialZones == nullptr && allocateZone() == nullptr)
+        return nullptr;
+
+    auto* zone = m_partialZones;
+    if (zone->freeChunksCount() == zone->chunksCount())
+        --m_emptyZonesCount;
+
+    auto* chunk = zone->takeChunk();
+    if (zone->freeChunksCount() == 0) {
+        zone->removeFromList(&m_partialZones);
+        zone->addToList(&m_fullZones);
+    }
+
+    auto* object = utils::movePtr(reinterpret_cast<char*>(chunk), m_objectOffset);
+    if (m_hooks.ctor != nullptr)
+        m_hooks.ctor(object, m_hooks.arg);
+
+    // Shrinkers armed by the allocation of the zone may use this cache, so they are called only once it is consistent.
+    m_pageAllocator->reclaimPending();
+    return object;
+}
+
+void Cache::release(void* object)
+{
+    if (object == nullptr)
+        return;
+
+    auto* zone = findZone(object);
+    auto* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(object) - m_objectOffset);
+    assert(zone->isValidChunk(chunk));
+
+    if (m_hooks.dtor != nullptr)
+        m_hooks.dtor(object, m_hooks.arg);
+
+    if (zone->freeChunksCount() == 0) {
+        zone->removeFromList(&m_fullZones);
+        zone->addToList(&m_partialZones);
+    }
+
+    chunk->initListNode();
+    zone->giveChunk(chunk);
+    if (zone->freeChunksCount() != zone->chunksCount())
+        return;
+
+    // One empty zone is kept to avoid calling init and fini hooks on all its objects when usage oscillates.
+    if (++m_emptyZonesCount > 1)
+        releaseZone(zone);
+}
+
+std::size_t Cache::shrink()
+{
+    std::size_t count = 0;
+    for (auto* zone = m_partialZones; zone != nullptr && m_emptyZonesCount != 0;) {
+        auto* next = zone->next();
+        if (zone->freeChunksCount() == zone->chunksCount()) {
+            releaseZone(zone);
+            ++count;
+        }
+
+        zone = next;
+    }
+
+    return count;
+}
+
+ZoneAllocator* Cache::zoneAllocator()
+{
+    return m_zoneAllocator;
+}
+
+const char* Cache::name() const
+{
+    return m_name;
+}
+
+std::size_t Cache::objectSize() const
+{
+    return m_objectSize;
+}
+
+std::size_t Cache::objectsPerZone() const
+{
+    return (m_chunkSize != 0) ? (m_pageSize - sizeof(Zone)) / m_chunkSize : 0;
+}
+
+std::size_t Cache::colorsCount() const
+{
+    return m_colorsCount;
+}
+
+std::size_t Cache::zonesCount() const
+{
+    std::size_t count = 0;
+    for (auto* list : {m_partialZones, m_fullZones}) {
+        for (auto* zone = list; zone != nullptr; zone = zone->next(), ++count) {}
+    }
+
+    return count;
+}
+
+Zone* Cache::allocateZone()
+{
+    auto* page = m_pageAllocator->allocate(1);
+    if (page == nullptr)
+        return nullptr;
+
+    // Page is marked as a zone page of this cache, so that objects released to the heap are given back to the cache.
+    page->setZone(true);
+    page->setCache(true);
+    page->setOwner(this);
+
+    auto* zone = findZone(reinterpret_cast<void*>(page->address()));
+    zone->init(page, m_pageSize - sizeof(Zone), m_chunkSize, m_nextColor * m_colorStep);
+    m_nextColor = (m_nextColor + 1) % m_colorsCount;
+
+    if (m_hooks.init != nullptr) {
+        auto* object = utils::movePtr(reinterpret_cast<char*>(page->address()), zone->offset() + m_objectOffset);
+        for (std::size_t i = 0; i < zone->chunksCount(); ++i, object = utils::movePtr(object, m_chunkSize))
+            m_hooks.init(object, m_hooks.arg);
+    }
+
+    zone->addToList(&m_partialZones);
+    ++m_emptyZonesCount;
+    return zone;
+}
+
+void Cache::releaseZone(Zone* zone)
+{
+    assert(zone);
+    assert(zone->freeChunksCount() == zone->chunksCount());
+
+    auto* page = zone->page();
+    if (m_hooks.fini != nullptr) {
+        auto* object = utils::movePtr(reinterpret_cast<char*>(page->address()), zone->offset() + m_objectOffset);
+        for (std::size_t i = 0; i < zone->chunksCount(); ++i, object = utils::movePtr(object, m_chunkSize))
+            m_hooks.fini(object, m_hooks.arg);
+    }
+
+    zone->removeFromList(&m_partialZones);
+    zone->clear();
+    --m_emptyZonesCount;
+
+    page->setZone(false);
+    page->setCache(false);
+    page->setOwner(nullptr);
+    m_pageAllocator->release(page);
+}
+
+Zone* Cache::findZone(void* object) const
+{
+    auto pageAddr = reinterpret_cast<std::uintptr_t>(object) & ~(m_pageSize - 1);
+    return reinterpret_cast<Zone*>(pageAddr + m_pageSize - sizeof(Zone));
+}
+
+void* cacheAllocate(Cache* cache)
+{
+    assert(cache);
+    return cache->allocate();
+}
+
+void cacheRelease(Cache* cache, void* object)
+{
+    assert(cache);
+    cache->release(object);
+}
+
+bool cacheDestroy(Cache* cache)
+{
+    if (cache == nullptr)
+        return true;
+
+    auto* zoneAllocator = cache->zoneAllocator();
+    if (!cache->clear())
+        return false;
+
+    cache->~Cache();
+    zoneAllocator->release(cache);
+    return true;
+}
+
+} // namespace memory
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ListNode.hpp"
+#include "Zone.hpp"
+
+#include <allocator/ObjectCache.hpp>
+
+#include <cstddef>
+
+namespace memory {
+
+class PageAllocator;
+class ZoneAllocator;
+
+/// Represents the cache of objects with the given size and alignment.
+/// @note Each zone of the cache occupies exactly one page and its descriptor is stored at the end of that page, so the
+///       zone of any object is found directly from its address. Chunks are not rounded up to a power of 2.
+/// @note Initialized cache is registered in its ZoneAllocator, so that the retained empty zones can be reclaimed.
+/// @note If the init or fini hook is given, then each chunk starts with its list node followed by the object, so that
+///       the free list never overwrites the cached objects. Otherwise list node overlaps the released object.
+class Cache : public ListNode<Cache> {
+public:
+    /// Default constructor.
+    Cache() = default;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Cache is not meant to be copy-constructed.
+    Cache(const Cache&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Cache is not meant to be move-constructed.
+    Cache(Cache&&) = delete;
+
+    /// Destructor.
+    ~Cache() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Cache is not meant to be copy-assigned.
+    Cache& operator=(const Cache&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Cache is not meant to be move-assigned.
+    Cache& operator=(Cache&&) = delete;
+
+    /// Initializes the cache. It is used as a replacement for the constructor.
+    /// @param pageAllocator    PageAllocator to be used as the source of the pages.
+    /// @param zoneAllocator    ZoneAllocator, from which this cache descriptor has been allocated.
+    /// @param pageSize         Size of the page.
+    /// @param name             Name of the cache.
+    /// @param size             Size of the objects.
+    /// @param alignment        Alignment of the objects. It must be a power of 2.
+    /// @param hooks            Hooks to be called on the objects.
+    /// @return Result of the initialization.
+    /// @retval true            Cache has been initialized.
+    /// @retval false           Given parameters are invalid or the object does not fit into one page.
+    [[nodiscard]] bool init(PageAllocator* pageAllocator,
+                            ZoneAllocator* zoneAllocator,
+                            std::size_t pageSize,
+                            const char* name,
+                            std::size_t size,
+                            std::size_t alignment,
+                            const CacheHooks& hooks);
+
+    /// Gives all zones back to the PageAllocator and clears the internal state of the cache.
+    /// @return Result of the operation.
+    /// @retval true            Cache has been cleared.
+    /// @retval false           Some objects are still allocated, so the cache has been left untouched.
+    bool clear();
+
+    /// Allocates one object from the cache.
+    /// @return Result of the allocation.
+    /// @retval void*           Allocated object on success.
+    /// @retval nullptr         Some error occurred.
+    [[nodiscard]] void* allocate();
+
+    /// Releases the given object to the cache.
+    /// @param object           Object to be released.
+    void release(void* object);
+
+    /// Gives all empty zones, that are retained by the cache, back to the PageAllocator.
+    /// @return Number of zones, that have been given back.
+    std::size_t shrink();
+
+    /// Returns the ZoneAllocator, from which this cache descriptor has been allocated.
+    /// @return ZoneAllocator owning this cache descriptor.
+    ZoneAllocator* zoneAllocator();
+
+    /// Returns the name of the cache.
+    /// @return Name of the cache.
+    [[nodiscard]] const char* name() const;
+
+    /// Returns size of the objects in the cache.
+    /// @return Size of the objects in the cache.
+    [[nodiscard]] std::size_t objectSize() const;
+
+    /// Returns the number of objects, that fit into one zone.
+    /// @return Number of objects in one zone.
+    [[nodiscard]] std::size_t objectsPerZone() const;
+
+    /// Returns the number of different offsets of the first object, that consecutive zones are given.
+    /// @return Number of colors used by the cache.
+    /// @note Colors are taken from the slack left at the end of the zone, so objects at the same index in different
+    ///       zones are mapped to different cache sets.
+    [[nodiscard]] std::size_t colorsCount() const;
+
+    /// Returns the number of zones currently owned by the cache.
+    /// @return Number of zones owned by the cache.
+    [[nodiscard]] std::size_t zonesCount() const;
+
+private:
+    /// Allocates new zone from the PageAllocator and brings all its objects into the cache.
+    /// @return Result of the allocation.
+    /// @retval Zone*           Allocated zone on success.
+    /// @retval nullptr         Some error occurred.
+    Zone* allocateZone();
+
+    /// Removes all objects of the given zone from the cache and gives its page back to the PageAllocator.
+    /// @param zone             Zone to be released.
+    void releaseZone(Zone* zone);
+
+    /// Returns the zone, that given object belongs to.
+    /// @param object           Object for which zone should be returned.
+    /// @return Zone, that given object belongs to.
+    Zone* findZone(void* object) const;
+
+private:
+    PageAllocator* m_pageAllocator{}; ///< PageAllocator to be used as the source of the pages.
+    ZoneAllocator* m_zoneAllocator{}; ///< ZoneAllocator, from which this cache descriptor has been allocated.
+    std::size_t m_pageSize{};         ///< Size of the page.
+    const char* m_name{};             ///< Name of the cache.
+    std::size_t m_objectSize{};       ///< Size of the objects.
+    std::size_t m_objectOffset{};     ///< Offset of the object within its chunk.
+    std::size_t m_chunkSize{};        ///< Size of the chunk holding one object.
+    std::size_t m_colorStep{};        ///< Difference between offsets of the first chunk in consecutive colors.
+    std::size_t m_colorsCount{};      ///< Number of colors, that fit into the slack of the zone.
+    std::size_t m_nextColor{};        ///< Color to be used by the next allocated zone.
+    CacheHooks m_hooks{};             ///< Hooks to be called on the objects.
+    Zone* m_partialZones{};           ///< List of zones with at least one free chunk.
+    Zone* m_fullZones{};              ///< List of zones without free chunks.
+    std::size_t m_emptyZonesCount{};  ///< Number of zones without allocated chunks.
+};
+
+} // namespace memory
@@ -0,0 +1,309 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "Cache.hpp"
+#include "PageAllocator.hpp"
+#include "ZoneAllocator.hpp"
+#include "utils.hpp"
+
+#include <allocator/Heap.hpp>
+
+#include <algorithm>
+#include <array>
+#include <new>
+
+namespace memory {
+namespace {
+
+/// Gives the empty zones retained by the object caches back to the PageAllocator.
+/// @param size         Demanded size of the memory to be released (unused).
+/// @param arg          ZoneAllocator owning the object caches.
+/// @return Size of the memory, that has been released.
+std::size_t shrinkCaches(std::size_t /*size*/, void* arg)
+{
+    return static_cast<ZoneAllocator*>(arg)->shrinkCaches();
+}
+
+/// Calls the shrinkers deferred by the allocation, that has just finished.
+/// @param pageAllocator    PageAllocator of the heap.
+/// @param result           Result of the allocation.
+/// @return Result of the allocation.
+template <typename T>
+T reclaimAfter(PageAllocator& pageAllocator, T result)
+{
+    pageAllocator.reclaimPending();
+    return result;
+}
+
+} // namespace
+
+/// Represents the internal state of the heap.
+struct Heap::Impl {
+    PageAllocator pageAllocator; ///< PageAllocator managing the regions of the heap.
+    ZoneAllocator zoneAllocator; ///< ZoneAllocator serving the allocations from the heap.
+    std::size_t pageSize{};      ///< Size of the page used by the heap.
+};
+
+Heap::Heap() noexcept
+{
+    static_assert(sizeof(Impl) <= m_cStorageSize, "Heap storage is too small");
+    static_assert(alignof(Impl) <= alignof(std::max_align_t), "Heap storage is not properly aligned");
+
+    new (m_storage.data()) Impl{};
+}
+
+Heap::~Heap()
+{
+    clear();
+    impl().~Impl();
+}
+
+bool Heap::init(Region* regions, std::size_t pageSize, bool zeroed)
+{
+    clear();
+
+    auto& state = impl();
+    if (!state.pageAllocator.init(regions, pageSize, zeroed))
+        return false;
+
+    state.pageSize = pageSize;
+    if (!state.zoneAllocator.init(&state.pageAllocator, pageSize))
+        return false;
+
+    // Empty zones retained by the object caches are the cheapest memory to reclaim, so they are always asked first.
+    return state.pageAllocator.addShrinker({shrinkCaches, &state.zoneAllocator});
+}
+
+bool Heap::init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize, bool zeroed)
+{
+    std::array<Region, 2> regions = {
+        {{start, end - start}, {0, 0}}
+    };
+
+    return init(regions.data(), pageSize, zeroed);
+}
+
+bool Heap::addRegion(const Region& region, bool zeroed)
+{
+    return impl().pageAllocator.addRegion(region, zeroed);
+}
+
+void Heap::setPageProvider(PageProvider* provider, std::size_t directThreshold)
+{
+    impl().pageAllocator.setProvider(provider, directThreshold);
+}
+
+void Heap::setDecommitThreshold(std::size_t threshold)
+{
+    impl().pageAllocator.setDecommitThreshold(threshold);
+}
+
+std::size_t Heap::trim()
+{
+    return impl().pageAllocator.trim();
+}
+
+void Heap::setEmergencyReserve(std::size_t size)
+{
+    impl().pageAllocator.setEmergencyReserve(size);
+}
+
+void Heap::setWatermarks(std::size_t low, std::size_t high)
+{
+    impl().pageAllocator.setWatermarks(low, high);
+}
+
+bool Heap::addShrinker(const allocator::Shrinker& shrinker)
+{
+    return impl().pageAllocator.addShrinker(shrinker);
+}
+
+void Heap::removeShrinker(const allocator::Shrinker& shrinker)
+{
+    impl().pageAllocator.removeShrinker(shrinker);
+}
+
+void Heap::clear()
+{
+    auto& state = impl();
+    state.pageAllocator.releaseProvidedRegions();
+    state.zoneAllocator.clear();
+    state.pageSize = 0;
+}
+
+bool Heap::reset()
+{
+    auto& state = impl();
+    if (state.pageSize == 0)
+        return false;
+
+    state.pageAllocator.reset();
+    return state.zoneAllocator.init(&state.pageAllocator, state.pageSize);
+}
+
+void* Heap::allocate(std::size_t size)
+{
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.allocate(size));
+}
+
+allocator::AllocationResult Heap::allocateAtLeast(std::size_t size)
+{
+    auto& state = impl();
+    if (auto* ptr = allocate(size))
+        return {ptr, state.zoneAllocator.allocationSize(size)};
+
+    return {nullptr, 0};
+}
+
+void* Heap::allocateSizeClass(std::size_t sizeClass)
+{
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.allocateSizeClass(sizeClass));
+}
+
+void* Heap::allocateZeroed(std::size_t size)
+{
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.allocateZeroed(size));
+}
+
+void* Heap::allocateCritical(std::size_t size)
+{
+    auto& state = impl();
+    if (auto* ptr = allocate(size))
+        return ptr;
+
+    state.pageAllocator.setReserveUnlocked(true);
+    auto* ptr = state.zoneAllocator.allocate(size);
+    state.pageAllocator.setReserveUnlocked(false);
+    return reclaimAfter(state.pageAllocator, ptr);
+}
+
+void* Heap::allocateAligned(std::size_t size, std::size_t alignment)
+{
+    if (!utils::isPowerOf2(alignment))
+        return nullptr;
+
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.allocateAligned(size, alignment));
+}
+
+bool Heap::allocateBatch(std::size_t size, void** ptrs, std::size_t count)
+{
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.allocateBatch(size, ptrs, count));
+}
+
+void Heap::release(void* ptr)
+{
+    impl().zoneAllocator.release(ptr);
+}
+
+void Heap::release(void* ptr, std::size_t size)
+{
+    impl().zoneAllocator.release(ptr, size);
+}
+
+void Heap::releaseSizeClass(void* ptr, std::size_t sizeClass)
+{
+    impl().zoneAllocator.releaseSizeClass(ptr, sizeClass);
+}
+
+void Heap::releaseBatch(void** ptrs, std::size_t count)
+{
+    impl().zoneAllocator.releaseBatch(ptrs, count);
+}
+
+void* Heap::reallocate(void* ptr, std::size_t size)
+{
+    auto& state = impl();
+    return reclaimAfter(state.pageAllocator, state.zoneAllocator.reallocate(ptr, size));
+}
+
+std::size_t Heap::usableSize(void* ptr)
+{
+    return impl().zoneAllocator.usableSize(ptr);
+}
+
+Cache* Heap::cacheCreate(const char* name, std::size_t size, std::size_t alignment, const CacheHooks& hooks)
+{
+    auto& state = impl();
+    auto* memory = allocate(sizeof(Cache));
+    if (memory == nullptr)
+        return nullptr;
+
+    auto* cache = new (memory) Cache();
+    if (!cache->init(&state.pageAllocator, &state.zoneAllocator, state.pageSize, name, size, alignment, hooks)) {
+        cache->~Cache();
+        state.zoneAllocator.release(memory);
+        return nullptr;
+    }
+
+    return cache;
+}
+
+allocator::Stats Heap::getStats()
+{
+    PageAllocator::Stats pageStats = impl().pageAllocator.getStats();
+    ZoneAllocator::Stats zoneStats = impl().zoneAllocator.getStats();
+
+    allocator::Stats stats{};
+    stats.totalMemorySize = pageStats.totalMemorySize;
+    stats.reservedMemorySize = pageStats.totalMemorySize - pageStats.effectiveMemorySize // Lost due to the alignment.
+                             + pageStats.reservedPagesCount * pageStats.pageSize // Reserved by the PageAllocator.
+                             + zoneStats.reservedMemorySize;                     // Reserved by the ZoneAllocator.
+    stats.userMemorySize = stats.totalMemorySize - stats.reservedMemorySize;
+    stats.allocatedMemorySize = pageStats.userMemorySize - pageStats.freeMemorySize
+                              - zoneStats.usedMemorySize       // Allocated from PageAllocator by user.
+                              + zoneStats.allocatedMemorySize; // Allocated from ZoneAllocator by user.
+    stats.freeMemorySize = stats.userMemorySize - stats.allocatedMemorySize;
+
+    auto freePagesCount = pageStats.freePagesCount;
+    auto reservePagesCount = pageStats.emergencyPagesCount;
+    stats.emergencySize = reservePagesCount * pageStats.pageSize;
+    stats.emergencyUsedSize = (reservePagesCount - std::min(reservePagesCount, freePagesCount)) * pageStats.pageSize;
+
+    return stats;
+}
+
+std::size_t Heap::pageSize()
+{
+    return impl().pageSize;
+}
+
+Heap::Impl& Heap::impl()
+{
+    return *std::launder(reinterpret_cast<Impl*>(m_storage.data()));
+}
+
+} // namespace memory
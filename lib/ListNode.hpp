@@ -96,6 +96,8 @@ public:
     }
 
 private:
+    friend T;
+
     T* m_next{}; ///< Next node in the list.
     T* m_prev{}; ///< Previous node in the list.
 };
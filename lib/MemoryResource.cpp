@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+
+#include <algorithm>
+
+namespace memory {
+namespace {
+
+/// Returns size of the heap allocation, that satisfies both the given size and alignment.
+/// @param bytes        Demanded size of the memory block.
+/// @param alignment    Demanded alignment of the memory block.
+/// @return Size to be passed to the heap.
+/// @note Zone chunks are aligned to their size and page allocations to the page size, so it is enough to request
+///       at least alignment bytes as long as alignment does not exceed the page size.
+std::size_t heapAllocSize(std::size_t bytes, std::size_t alignment)
+{
+    return std::max({bytes, alignment, std::size_t(1)});
+}
+
+} // namespace
+
+HeapResource::HeapResource(Heap& heap) noexcept
+    : m_heap(&heap)
+{}
+
+Heap& HeapResource::heap() const
+{
+    return *m_heap;
+}
+
+void* HeapResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* ptr = nullptr;
+    if (alignment <= m_heap->pageSize())
+        ptr = m_heap->allocate(heapAllocSize(bytes, alignment));
+    else
+        ptr = m_heap->allocateAligned(std::max(bytes, std::size_t(1)), alignment);
+
+    if (ptr == nullptr)
+        detail::allocationFailed();
+
+    return ptr;
+}
+
+void HeapResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+{
+    // Over-aligned blocks are bigger than the demanded size, so their size is looked up by the heap.
+    if (alignment > m_heap->pageSize())
+        m_heap->release(ptr);
+    else
+        m_heap->release(ptr, heapAllocSize(bytes, alignment));
+}
+
+bool HeapResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+ArenaResource::ArenaResource(Arena& arena) noexcept
+    : m_arena(&arena)
+{}
+
+Arena& ArenaResource::arena() const
+{
+    return *m_arena;
+}
+
+void* ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (auto* ptr = m_arena->allocate(std::max(bytes, std::size_t(1)), alignment))
+        return ptr;
+
+    detail::allocationFailed();
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace memory
@@ -0,0 +1,145 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <allocator/MmapPageProvider.hpp>
+
+#include "utils.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+namespace memory {
+namespace {
+
+constexpr int cProtection = PROT_READ | PROT_WRITE;                 ///< Protection of all mapped regions.
+constexpr int cFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE; ///< Flags of the regular mappings.
+
+} // namespace
+
+MmapPageProvider::MmapPageProvider(bool lazyFree, bool hugePages) noexcept
+    : m_lazyFree(lazyFree)
+    , m_hugePages(hugePages)
+{}
+
+Region MmapPageProvider::allocate(std::size_t size)
+{
+    if (size == 0)
+        return {0, 0};
+
+    if (m_hugePages)
+        return allocateHuge(utils::roundUp(size, hugePageSize()));
+
+    auto* addr = mmap(nullptr, size, cProtection, cFlags, -1, 0);
+    if (addr == MAP_FAILED)
+        return {0, 0};
+
+    return {reinterpret_cast<std::uintptr_t>(addr), size};
+}
+
+void MmapPageProvider::release(const Region& region)
+{
+    munmap(reinterpret_cast<void*>(region.address), region.size); // NOLINT(performance-no-int-to-ptr)
+}
+
+bool MmapPageProvider::move(const Region& from, std::uintptr_t to)
+{
+    auto systemPageSize = static_cast<std::size_t>(getpagesize());
+    if (from.address % systemPageSize != 0 || from.size % systemPageSize != 0 || to % systemPageSize != 0)
+        return false;
+
+    // Fixed destination replaces the pages mapped there, so the range lands inside of the other region.
+    auto* addr = mremap(reinterpret_cast<void*>(from.address), // NOLINT(performance-no-int-to-ptr)
+                        from.size,
+                        from.size,
+                        MREMAP_MAYMOVE | MREMAP_FIXED,
+                        reinterpret_cast<void*>(to)); // NOLINT(performance-no-int-to-ptr)
+    return (addr != MAP_FAILED);
+}
+
+bool MmapPageProvider::decommit(const Region& region)
+{
+    // Ranges smaller than the system page would drop the content of their neighbours and ranges smaller than the huge
+    // page would split it, so they are left untouched.
+    auto alignment = decommitAlignment();
+    if (region.address % alignment != 0 || region.size % alignment != 0)
+        return false;
+
+#ifdef MADV_FREE
+    int advice = m_lazyFree ? MADV_FREE : MADV_DONTNEED;
+#else
+    int advice = MADV_DONTNEED;
+#endif
+
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    return (madvise(reinterpret_cast<void*>(region.address), region.size, advice) == 0);
+}
+
+std::size_t MmapPageProvider::decommitAlignment() const
+{
+    return m_hugePages ? hugePageSize() : static_cast<std::size_t>(getpagesize());
+}
+
+Region MmapPageProvider::allocateHuge(std::size_t size)
+{
+#ifdef MAP_HUGETLB
+    // Swap reservation is kept, so that mmap() fails instead of the later page fault, when the pool is too small.
+    auto* addr = mmap(nullptr, size, cProtection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr != MAP_FAILED)
+        return {reinterpret_cast<std::uintptr_t>(addr), size};
+#endif
+
+    // Transparent huge pages back only the aligned ranges, so the excess of the bigger mapping is unmapped.
+    auto mappedSize = size + hugePageSize();
+    auto* mapped = mmap(nullptr, mappedSize, cProtection, cFlags, -1, 0);
+    if (mapped == MAP_FAILED)
+        return {0, 0};
+
+    auto start = reinterpret_cast<std::uintptr_t>(mapped);
+    auto alignedStart = utils::roundUp(start, hugePageSize());
+    auto alignedEnd = alignedStart + size;
+    if (alignedStart != start)
+        munmap(mapped, alignedStart - start);
+
+    auto mappedEnd = start + mappedSize;
+    if (alignedEnd != mappedEnd)
+        munmap(reinterpret_cast<void*>(alignedEnd), mappedEnd - alignedEnd); // NOLINT(performance-no-int-to-ptr)
+
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(alignedStart), size, MADV_HUGEPAGE); // NOLINT(performance-no-int-to-ptr)
+#endif
+
+    return {alignedStart, size};
+}
+
+} // namespace memory
@@ -63,6 +63,42 @@ void Page::setUsed(bool value)
     m_flags.bits.used = value;
 }
 
+void Page::setZeroed(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.zeroed = value;
+}
+
+void Page::setDecommitted(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.decommitted = value;
+}
+
+void Page::setZone(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.zone = value;
+}
+
+void Page::setCache(bool value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.cache = value;
+}
+
+void Page::setZoneIdx(std::size_t idx)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    m_flags.bits.zoneIdx = idx;
+}
+
+void Page::setOwner(void* owner)
+{
+    assert(m_next == nullptr);
+    m_prev = static_cast<Page*>(owner);
+}
+
 Page* Page::nextSibling()
 {
     return (this + 1);
@@ -90,4 +126,39 @@ bool Page::isUsed() const
     return m_flags.bits.used;
 }
 
+bool Page::isZeroed() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.zeroed;
+}
+
+bool Page::isDecommitted() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.decommitted;
+}
+
+bool Page::isZone() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.zone;
+}
+
+bool Page::isCache() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.cache;
+}
+
+std::size_t Page::zoneIdx() const
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    return m_flags.bits.zoneIdx;
+}
+
+void* Page::owner() const
+{
+    return m_prev;
+}
+
 } // namespace memory
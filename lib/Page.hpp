@@ -81,8 +81,40 @@ public:
 
     /// Sets the 'used' flag of the current page to the given state.
     /// @param value        State to be set.
+    /// @note Used flag should be set only to the first and to the last page in the group.
     void setUsed(bool value);
 
+    /// Sets the 'zeroed' flag of the current page to the given state.
+    /// @param value        State to be set.
+    /// @note Zeroed flag is tracked for every page separately and is valid only while the page is free.
+    void setZeroed(bool value);
+
+    /// Sets the 'decommitted' flag of the current page to the given state.
+    /// @param value        State to be set.
+    /// @note Decommitted flag is tracked for every page separately and is set only for free pages.
+    void setDecommitted(bool value);
+
+    /// Sets the 'zone' flag of the current page to the given state.
+    /// @param value        State to be set.
+    /// @note Zone flag is set only for pages, that are divided into chunks by a Zone.
+    void setZone(bool value);
+
+    /// Sets the 'cache' flag of the current page to the given state.
+    /// @param value        State to be set.
+    /// @note Cache flag is set together with the zone flag for pages, whose zone belongs to an object cache.
+    void setCache(bool value);
+
+    /// Sets the index of the zone, that divides the current page into chunks.
+    /// @param idx          Index of the zone to be set.
+    /// @note Zone index is valid only if the 'zone' flag is set.
+    void setZoneIdx(std::size_t idx);
+
+    /// Sets the object, that divides the current page into chunks.
+    /// @param owner        Object to be set.
+    /// @note Owner is kept in place of the list node, because used pages are never linked into any list. Thus it is
+    ///       valid only if the 'zone' flag is set and it has to be reset to nullptr before the page is released.
+    void setOwner(void* owner);
+
     /// Returns the page, that lies immediately after the given page.
     /// @return Pointer to the next sibling page.
     Page* nextSibling();
@@ -105,6 +137,38 @@ public:
     /// @retval false       Page is not used.
     [[nodiscard]] bool isUsed() const;
 
+    /// Returns flag indicating if current page is known to contain only zeros.
+    /// @return Flag indicating if current page is known to contain only zeros.
+    /// @retval true        Page contains only zeros.
+    /// @retval false       Content of the page is unknown.
+    [[nodiscard]] bool isZeroed() const;
+
+    /// Returns flag indicating if physical memory of the current page has been given back to the system.
+    /// @return Flag indicating if current page is decommitted.
+    /// @retval true        Page is decommitted and has to be committed again before it is used.
+    /// @retval false       Page is backed by physical memory.
+    [[nodiscard]] bool isDecommitted() const;
+
+    /// Returns flag indicating if current page is divided into chunks by a Zone.
+    /// @return Flag indicating if current page is divided into chunks by a Zone.
+    /// @retval true        Page belongs to a Zone.
+    /// @retval false       Page does not belong to any Zone.
+    [[nodiscard]] bool isZone() const;
+
+    /// Returns flag indicating if the zone of the current page belongs to an object cache.
+    /// @return Flag indicating if the zone of the current page belongs to an object cache.
+    /// @retval true        Page is divided into chunks by an object cache, which is set as its owner.
+    /// @retval false       Page is not used by any object cache.
+    [[nodiscard]] bool isCache() const;
+
+    /// Returns index of the zone, that divides the current page into chunks.
+    /// @return Index of the zone.
+    [[nodiscard]] std::size_t zoneIdx() const;
+
+    /// Returns the object, that divides the current page into chunks.
+    /// @return Owner of the page.
+    [[nodiscard]] void* owner() const;
+
     /// Checks if the Page class is naturally aligned.
     /// @return Flag indicating it the Page class is naturally aligned.
     /// @retval true        Page class is naturally aligned.
@@ -123,7 +187,12 @@ private:
     union Flags {
         struct PageFlags {
             std::size_t groupSize : 21; ///< Size of the group. This is set only for the first and last page in group.
-            bool used             : 1;  ///< Flag indicating whether this page is used or not.
+            bool used             : 1;  ///< Flag indicating whether this page is used. Set as the group size.
+            bool zeroed           : 1;  ///< Flag indicating whether this free page is known to contain only zeros.
+            bool zone             : 1;  ///< Flag indicating whether this page is divided into chunks by a Zone.
+            std::size_t zoneIdx   : 4;  ///< Index of the zone, that this page belongs to. Set with the zone flag.
+            bool decommitted      : 1;  ///< Flag indicating whether physical memory of this free page is given back.
+            bool cache            : 1;  ///< Flag indicating whether the zone of this page belongs to an object cache.
         };
 
         PageFlags bits;
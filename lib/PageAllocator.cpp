@@ -33,10 +33,14 @@
 #include "PageAllocator.hpp"
 
 #include "Page.hpp"
+#include "allocator/PageProvider.hpp"
 #include "allocator/Region.hpp"
 #include "group.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <numeric>
 #include <tuple>
 
@@ -47,7 +51,7 @@ PageAllocator::PageAllocator() noexcept
     clear();
 }
 
-bool PageAllocator::init(Region* regions, std::size_t pageSize)
+bool PageAllocator::init(Region* regions, std::size_t pageSize, bool zeroed)
 {
     assert(regions);
 
@@ -61,14 +65,17 @@ bool PageAllocator::init(Region* regions, std::size_t pageSize)
             return false;
 
         RegionInfo regionInfo{};
-        if (initRegionInfo(regionInfo, regions[i], pageSize))
+        if (initRegionInfo(regionInfo, regions[i], pageSize)) {
+            limitRegionInfo(regionInfo, pageSize);
             m_regionsInfo.at(m_validRegionsCount++) = regionInfo;
+        }
     }
 
     if ((m_pagesCount = countPages()) == 0)
         return false;
 
     m_pageSize = pageSize;
+    m_zeroedPages = zeroed;
     m_descRegionIdx = chooseDescRegion();
     m_pagesHead = reinterpret_cast<Page*>(m_regionsInfo.at(m_descRegionIdx).alignedStart);
     m_pagesTail = m_pagesHead + m_pagesCount - 1;
@@ -84,6 +91,7 @@ bool PageAllocator::init(Region* regions, std::size_t pageSize)
             assert(page);
             page->init();
             page->setAddress(addr);
+            page->setZeroed(zeroed);
             page = page->nextSibling();
         }
 
@@ -92,6 +100,7 @@ bool PageAllocator::init(Region* regions, std::size_t pageSize)
 
         if (i == m_descRegionIdx) {
             m_descPagesCount = reserveDescPages();
+            region.descPagesCount = m_descPagesCount;
             std::tie(std::ignore, group) = splitGroup(group, m_descPagesCount);
         }
 
@@ -102,6 +111,167 @@ bool PageAllocator::init(Region* regions, std::size_t pageSize)
     return true;
 }
 
+bool PageAllocator::addRegion(const Region& region, bool zeroed)
+{
+    if (m_pageSize == 0 || m_validRegionsCount == m_cMaxRegionsCount)
+        return false;
+
+    RegionInfo regionInfo{};
+    if (!initRegionInfo(regionInfo, region, m_pageSize))
+        return false;
+
+    limitRegionInfo(regionInfo, m_pageSize);
+
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        auto& knownRegion = m_regionsInfo.at(i);
+        if (regionInfo.alignedStart < knownRegion.alignedEnd && knownRegion.alignedStart < regionInfo.alignedEnd)
+            return false;
+    }
+
+    // Page descriptors are stored at the beginning of the region, so at least one page has to remain for the user.
+    auto descPagesCount = utils::divRoundUp(regionInfo.pageCount * sizeof(Page), m_pageSize);
+    if (descPagesCount >= regionInfo.pageCount)
+        return false;
+
+    regionInfo.firstPage = reinterpret_cast<Page*>(regionInfo.alignedStart);
+    regionInfo.lastPage = regionInfo.firstPage + regionInfo.pageCount - 1;
+    regionInfo.descPagesCount = descPagesCount;
+
+    auto* page = regionInfo.firstPage;
+    for (auto addr = regionInfo.alignedStart; addr != regionInfo.alignedEnd; addr += m_pageSize) {
+        page->init();
+        page->setAddress(addr);
+        page->setZeroed(zeroed && m_zeroedPages);
+        page = page->nextSibling();
+    }
+
+    initGroup(regionInfo.firstPage, regionInfo.pageCount);
+    auto [descGroup, group] = splitGroup(regionInfo.firstPage, descPagesCount);
+    for (page = descGroup; page != group; page = page->nextSibling())
+        page->setUsed(true);
+
+    m_regionsInfo.at(m_validRegionsCount++) = regionInfo;
+    m_pagesCount += regionInfo.pageCount;
+    m_descPagesCount += descPagesCount;
+    addGroup(group);
+    return true;
+}
+
+void PageAllocator::setProvider(PageProvider* provider, std::size_t directThreshold)
+{
+    m_provider = provider;
+    m_directThreshold = directThreshold;
+    updateGrowSize();
+}
+
+void PageAllocator::setDecommitThreshold(std::size_t threshold)
+{
+    m_decommitThreshold = threshold;
+}
+
+std::size_t PageAllocator::trim()
+{
+    if (m_provider == nullptr)
+        return 0;
+
+    // Single pages could pin the empty regions, so the page cache is emptied first.
+    drainPageCache(m_cachedPagesCount);
+
+    // Empty region is kept only to avoid obtaining it again on the next allocation, so it is given back first.
+    std::size_t releasedCount = 0;
+    for (auto i = m_validRegionsCount; i != 0; --i) {
+        auto& region = m_regionsInfo.at(i - 1);
+        if (!region.provided || !isEmptyRegion(region))
+            continue;
+
+        auto* group = region.firstPage + region.descPagesCount;
+        releasedCount += group->groupSize();
+        removeGroup(group);
+        releaseProvidedRegion(&region);
+    }
+
+    return releasedCount * pageSize() + decommitFreePages();
+}
+
+std::size_t PageAllocator::decommitFreePages()
+{
+    if (m_provider == nullptr)
+        return 0;
+
+    // Single pages are decommitted together with their free neighbours, so the page cache is emptied first.
+    drainPageCache(m_cachedPagesCount);
+
+    std::size_t decommittedCount = 0;
+    for (auto* list : m_freeGroupLists) {
+        for (auto* group = list; group != nullptr; group = group->next())
+            decommittedCount += decommitGroup(group);
+    }
+
+    m_retainedPagesCount = m_freePagesCount - m_decommittedPagesCount;
+    return decommittedCount * pageSize();
+}
+
+void PageAllocator::setWatermarks(std::size_t low, std::size_t high)
+{
+    m_lowWatermark = low;
+    m_highWatermark = std::max(low, high);
+    m_reclaimArmed = true;
+}
+
+void PageAllocator::reclaimPending()
+{
+    if (!m_reclaimPending)
+        return;
+
+    m_reclaimPending = false;
+    reclaim(m_highWatermark, 0);
+}
+
+bool PageAllocator::addShrinker(const allocator::Shrinker& shrinker)
+{
+    if (shrinker.shrink == nullptr || m_shrinkersCount == m_cMaxShrinkersCount)
+        return false;
+
+    m_shrinkers.at(m_shrinkersCount++) = shrinker;
+    return true;
+}
+
+void PageAllocator::removeShrinker(const allocator::Shrinker& shrinker)
+{
+    auto isSame = [&](const allocator::Shrinker& other) {
+        return other.shrink == shrinker.shrink && other.arg == shrinker.arg;
+    };
+
+    auto* end = m_shrinkers.begin() + m_shrinkersCount;
+    auto* it = std::find_if(m_shrinkers.begin(), end, isSame);
+    if (it == end)
+        return;
+
+    std::move(it + 1, end, it);
+    m_shrinkers.at(--m_shrinkersCount) = {};
+}
+
+void PageAllocator::setEmergencyReserve(std::size_t size)
+{
+    m_emergencyPagesCount = (m_pageSize != 0) ? utils::divRoundUp(size, pageSize()) : 0;
+}
+
+void PageAllocator::setReserveUnlocked(bool unlocked)
+{
+    m_reserveUnlocked = unlocked;
+}
+
+void PageAllocator::releaseProvidedRegions()
+{
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        auto& region = m_regionsInfo.at(i);
+        if (region.provided && m_provider != nullptr)
+            m_provider->release({region.start, region.size});
+    }
+
+    clear();
+}
+
 void PageAllocator::clear()
 {
     for (auto& region : m_regionsInfo)
@@ -116,9 +286,543 @@ void PageAllocator::clear()
     m_freeGroupLists.fill(nullptr);
     m_pagesCount = 0;
     m_freePagesCount = 0;
+    m_pageCache = nullptr;
+    m_cachedPagesCount = 0;
+    m_zeroedPages = false;
+    m_provider = nullptr;
+    m_directThreshold = 0;
+    m_growSize = 0;
+    m_decommitThreshold = 0;
+    m_decommittedPagesCount = 0;
+    m_retainedPagesCount = 0;
+    m_lowWatermark = 0;
+    m_highWatermark = 0;
+    m_reclaimArmed = false;
+    m_reclaimPending = false;
+    m_reclaiming = false;
+    m_shrinkers.fill({});
+    m_shrinkersCount = 0;
+    m_emergencyPagesCount = 0;
+    m_reserveUnlocked = false;
+}
+
+void PageAllocator::reset()
+{
+    m_freeGroupLists.fill(nullptr);
+    m_freePagesCount = 0;
+    m_pageCache = nullptr;
+    m_cachedPagesCount = 0;
+
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        auto& region = m_regionsInfo.at(i);
+
+        Page* group = region.firstPage + region.descPagesCount;
+        std::size_t groupSize = region.pageCount - region.descPagesCount;
+        region.sparePages = nullptr;
+        if (groupSize == 0)
+            continue;
+
+        initGroup(group, groupSize);
+        addGroup(group);
+    }
 }
 
 Page* PageAllocator::allocate(std::size_t count)
+{
+    auto* pages = allocatePages(count);
+    if (pages != nullptr && m_zeroedPages)
+        clearZeroed(pages, count);
+
+    return pages;
+}
+
+Page* PageAllocator::allocateZeroed(std::size_t count)
+{
+    auto* pages = allocatePages(count);
+    if (pages == nullptr)
+        return nullptr;
+
+    // Clear only the continuous runs of pages with unknown content.
+    Page* end = pages + count;
+    for (auto* page = pages; page != end;) {
+        if (page->isZeroed()) {
+            page->setZeroed(false);
+            page = page->nextSibling();
+            continue;
+        }
+
+        auto* runStart = page;
+        for (; page != end && !page->isZeroed(); page = page->nextSibling()) {}
+
+        auto runSize = static_cast<std::size_t>(page - runStart) * m_pageSize;
+        std::memset(reinterpret_cast<void*>(runStart->address()), 0, runSize);
+    }
+
+    return pages;
+}
+
+Page* PageAllocator::allocateAligned(std::size_t count, std::size_t alignment)
+{
+    assert(utils::isPowerOf2(alignment));
+
+    if (alignment <= pageSize())
+        return allocate(count);
+
+    auto extraCount = alignment / pageSize() - 1;
+    if (count > std::numeric_limits<std::size_t>::max() - extraCount)
+        return nullptr;
+
+    auto* pages = allocate(count + extraCount);
+    if (pages == nullptr)
+        return nullptr;
+
+    auto headCount = (utils::roundUp(pages->address(), alignment) - pages->address()) / pageSize();
+    if (headCount != 0) {
+        auto [headGroup, alignedGroup] = splitGroup(pages, headCount);
+        markGroup(headGroup, true);
+        markGroup(alignedGroup, true);
+        release(headGroup);
+        pages = alignedGroup;
+    }
+
+    [[maybe_unused]] bool resized = resize(pages, count);
+    assert(resized);
+    return pages;
+}
+
+void PageAllocator::release(Page* pages)
+{
+    if (pages == nullptr)
+        return;
+
+    if (pages->groupSize() != 1) {
+        releaseGroup(pages);
+    }
+    else {
+        pages->addToList(&m_pageCache);
+        ++m_cachedPagesCount;
+
+        if (m_cachedPagesCount > m_cMaxCachedPagesCount)
+            drainPageCache(m_cPageCacheBatchSize);
+    }
+
+    if (m_decommitThreshold == 0)
+        return;
+
+    // Pages, that the provider refused to decommit, would otherwise trigger the whole scan on every release.
+    auto committedCount = m_freePagesCount + m_cachedPagesCount - m_decommittedPagesCount;
+    m_retainedPagesCount = std::min(m_retainedPagesCount, committedCount);
+    if ((committedCount - m_retainedPagesCount) * pageSize() >= m_decommitThreshold)
+        decommitFreePages();
+}
+
+bool PageAllocator::resize(Page* pages, std::size_t count)
+{
+    assert(pages);
+    assert(pages->isUsed());
+
+    if (count == 0)
+        return false;
+
+    auto groupSize = pages->groupSize();
+    if (count == groupSize)
+        return true;
+
+    if (count < groupSize) {
+        auto [resizedGroup, remainingGroup] = splitGroup(pages, count);
+        markGroup(resizedGroup, true);
+        markGroup(remainingGroup, true);
+        release(remainingGroup);
+        return true;
+    }
+
+    Page* lastPage = pages + groupSize - 1;
+    Page* firstBelow = lastPage->nextSibling();
+    if (!isValidPage(firstBelow))
+        return false;
+
+    if (getRegion(lastPage->address()) != getRegion(firstBelow->address()))
+        return false;
+
+    if (firstBelow->isUsed())
+        return false;
+
+    auto missingCount = count - groupSize;
+    if (firstBelow->groupSize() < missingCount)
+        return false;
+
+    removeGroup(firstBelow);
+    auto [joinedGroup, remainingGroup] = splitGroup(firstBelow, missingCount);
+    if (remainingGroup != nullptr)
+        addGroup(remainingGroup);
+
+    if (m_decommittedPagesCount != 0)
+        commitPages(joinedGroup, missingCount);
+
+    if (m_zeroedPages)
+        clearZeroed(joinedGroup, missingCount);
+
+    markGroup(joinGroup(pages, joinedGroup), true);
+    return true;
+}
+
+Page* PageAllocator::remap(Page* pages, std::size_t count)
+{
+    assert(pages);
+    assert(pages->isUsed());
+
+    if (m_provider == nullptr || m_directThreshold == 0 || count > maxPagesCount()
+        || count * pageSize() < m_directThreshold)
+        return nullptr;
+
+    auto* region = getRegion(pages->address());
+    assert(region);
+    if (!region->provided || !isSoleGroup(*region, pages))
+        return nullptr;
+
+    auto groupSize = pages->groupSize();
+
+    auto* movedPages = allocateDirect(count);
+    if (movedPages == nullptr)
+        return nullptr;
+
+    // New region is always the last one, so the old one is not shifted, when the new one is given back.
+    Region movedRange{pages->address(), std::min(groupSize, count) * pageSize()};
+    if (!m_provider->move(movedRange, movedPages->address())) {
+        releaseGroup(movedPages);
+        return nullptr;
+    }
+
+    if (m_zeroedPages)
+        clearZeroed(movedPages, movedPages->groupSize());
+
+    releaseProvidedRegion(region);
+    return movedPages;
+}
+
+Page* PageAllocator::allocatePages(std::size_t count)
+{
+    // Requests, that cannot be described by a single group, would only make grow() obtain useless regions.
+    if (count == 0 || count > maxPagesCount())
+        return nullptr;
+
+    Page* pages = nullptr;
+    if (m_directThreshold != 0 && count * pageSize() >= m_directThreshold)
+        pages = allocateDirect(count);
+
+    if (pages == nullptr)
+        pages = allocateAvailable(count);
+
+    if (pages == nullptr && grow(count))
+        pages = allocateAvailable(count);
+
+    if (pages == nullptr && m_shrinkersCount != 0) {
+        auto reserveSize = m_reserveUnlocked ? 0 : m_emergencyPagesCount * pageSize();
+        auto demandedSize = std::max(freeMemorySize(), reserveSize) + count * pageSize();
+        pages = reclaim(std::max(m_highWatermark, demandedSize), count);
+    }
+
+    if (pages != nullptr && m_decommittedPagesCount != 0)
+        commitPages(pages, count);
+
+    // Shrinkers are woken up once per drop below the low watermark, so that they are not called on every allocation,
+    // when they have nothing more to release.
+    if (pages != nullptr && m_lowWatermark != 0) {
+        auto freeSize = freeMemorySize();
+        if (freeSize >= m_highWatermark) {
+            m_reclaimArmed = true;
+        }
+        else if (freeSize < m_lowWatermark && m_reclaimArmed && !m_reclaiming) {
+            m_reclaimArmed = false;
+            m_reclaimPending = true;
+        }
+    }
+
+    return pages;
+}
+
+Page* PageAllocator::allocateKnown(std::size_t count)
+{
+    if (count == 1) {
+        if (m_pageCache == nullptr && !refillPageCache())
+            return nullptr;
+
+        auto* page = m_pageCache;
+        page->removeFromList(&m_pageCache);
+        --m_cachedPagesCount;
+        return page;
+    }
+
+    auto* pages = allocateGroup(count);
+    if (pages == nullptr && m_cachedPagesCount != 0) {
+        drainPageCache(m_cachedPagesCount);
+        pages = allocateGroup(count);
+    }
+
+    return pages;
+}
+
+Page* PageAllocator::allocateAvailable(std::size_t count)
+{
+    // Normal allocations have to leave the emergency reserve free, while the critical ones can use it.
+    if (!m_reserveUnlocked && m_freePagesCount + m_cachedPagesCount < count + m_emergencyPagesCount)
+        return nullptr;
+
+    return allocateKnown(count);
+}
+
+Page* PageAllocator::allocateDirect(std::size_t count)
+{
+    // Last free region slot is left for grow(), so that direct allocations cannot stop the heap from growing.
+    if (m_validRegionsCount + 1 >= m_cMaxRegionsCount)
+        return nullptr;
+
+    auto* region = addProvidedRegion(regionSize(count));
+    if (region == nullptr)
+        return nullptr;
+
+    region->direct = true;
+    Page* group = region->firstPage + region->descPagesCount;
+    assert(group->groupSize() >= count);
+    removeGroup(group);
+
+    // Pages left over from the rounding of the region are never handed out, so that the group has exactly the demanded
+    // size and nothing else can keep the region from being given back together with it.
+    auto [directGroup, spareGroup] = splitGroup(group, count);
+    markGroup(directGroup, true);
+    if (spareGroup != nullptr) {
+        markGroup(spareGroup, true);
+        region->sparePages = spareGroup;
+    }
+
+    return directGroup;
+}
+
+bool PageAllocator::grow(std::size_t count)
+{
+    if (m_provider == nullptr)
+        return false;
+
+    // Region has to restore the part of the emergency reserve, that has been used, or the allocation would still fail.
+    auto freeCount = m_freePagesCount + m_cachedPagesCount;
+    auto reserveShortfall = m_reserveUnlocked ? 0 : m_emergencyPagesCount - std::min(m_emergencyPagesCount, freeCount);
+
+    // Geometric step may not be available anymore, so only the demanded size is tried after it.
+    auto minSize = regionSize(std::min(count + reserveShortfall, maxPagesCount()));
+    auto size = std::max(minSize, std::min(m_growSize, maxPagesCount() * pageSize()));
+    if (addProvidedRegion(size) == nullptr && (size == minSize || addProvidedRegion(minSize) == nullptr))
+        return false;
+
+    updateGrowSize();
+    return true;
+}
+
+Page* PageAllocator::reclaim(std::size_t size, std::size_t count)
+{
+    if (m_reclaiming)
+        return nullptr;
+
+    m_reclaiming = true;
+    Page* pages = nullptr;
+    for (std::size_t i = 0; i < m_shrinkersCount && pages == nullptr; ++i) {
+        auto freeSize = freeMemorySize();
+        if (count == 0 && freeSize >= size)
+            break;
+
+        auto& shrinker = m_shrinkers.at(i);
+        shrinker.shrink(size - std::min(size, freeSize), shrinker.arg);
+        if (count != 0)
+            pages = allocateAvailable(count);
+    }
+
+    m_reclaiming = false;
+    return pages;
+}
+
+RegionInfo* PageAllocator::addProvidedRegion(std::size_t size)
+{
+    if (m_provider == nullptr || m_validRegionsCount == m_cMaxRegionsCount)
+        return nullptr;
+
+    auto region = m_provider->allocate(size);
+    if (region.size == 0)
+        return nullptr;
+
+    if (!addRegion(region, m_provider->isZeroed())) {
+        m_provider->release(region);
+        return nullptr;
+    }
+
+    auto& regionInfo = m_regionsInfo.at(m_validRegionsCount - 1);
+    regionInfo.provided = true;
+    return &regionInfo;
+}
+
+void PageAllocator::releaseProvidedRegion(RegionInfo* region)
+{
+    assert(region);
+    assert(region->provided);
+
+    Region providedRegion{region->start, region->size};
+    if (m_decommittedPagesCount != 0) {
+        Page* end = region->lastPage->nextSibling();
+        for (auto* page = region->firstPage + region->descPagesCount; page != end; page = page->nextSibling())
+            m_decommittedPagesCount -= page->isDecommitted() ? 1 : 0;
+    }
+
+    m_pagesCount -= region->pageCount;
+    m_descPagesCount -= region->descPagesCount;
+
+    auto idx = static_cast<std::size_t>(region - m_regionsInfo.data());
+    assert(idx != m_descRegionIdx);
+    for (auto i = idx; i + 1 < m_validRegionsCount; ++i)
+        m_regionsInfo.at(i) = m_regionsInfo.at(i + 1);
+
+    clearRegionInfo(m_regionsInfo.at(--m_validRegionsCount));
+    if (m_descRegionIdx > idx)
+        --m_descRegionIdx;
+
+    // Growing continues from the memory, that is still known, so regions given back do not keep doubling the size.
+    updateGrowSize();
+    m_provider->release(providedRegion);
+}
+
+bool PageAllocator::isEmptyRegion(const RegionInfo& region) const
+{
+    auto* group = region.firstPage + region.descPagesCount;
+    return (!group->isUsed() && group->groupSize() == region.pageCount - region.descPagesCount);
+}
+
+bool PageAllocator::isSoleGroup(const RegionInfo& region, Page* group) const
+{
+    assert(group);
+
+    Page* firstPage = region.firstPage + region.descPagesCount;
+    Page* endPage = (region.sparePages != nullptr) ? region.sparePages : region.lastPage->nextSibling();
+    return (group == firstPage && group + group->groupSize() == endPage);
+}
+
+bool PageAllocator::shouldKeepRegion(const RegionInfo& region) const
+{
+    if (region.direct)
+        return false;
+
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        const auto& knownRegion = m_regionsInfo.at(i);
+        if (&knownRegion != &region && knownRegion.provided && !knownRegion.direct && isEmptyRegion(knownRegion))
+            return false;
+    }
+
+    return true;
+}
+
+void PageAllocator::updateGrowSize()
+{
+    // Next region obtained from the provider doubles the memory known so far. Dedicated regions do not count, because
+    // each of them holds a single allocation.
+    m_growSize = 0;
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        const auto& region = m_regionsInfo.at(i);
+        if (!region.direct)
+            m_growSize += region.alignedSize;
+    }
+}
+
+std::size_t PageAllocator::maxPagesCount() const
+{
+    return std::min(m_cMaxPagesCount, std::numeric_limits<std::size_t>::max() / pageSize() / 2);
+}
+
+void PageAllocator::limitRegionInfo(RegionInfo& regionInfo, std::size_t pageSize)
+{
+    if (regionInfo.pageCount <= m_cMaxRegionPagesCount)
+        return;
+
+    regionInfo.pageCount = m_cMaxRegionPagesCount;
+    regionInfo.alignedSize = regionInfo.pageCount * pageSize;
+    regionInfo.alignedEnd = regionInfo.alignedStart + regionInfo.alignedSize;
+}
+
+std::size_t PageAllocator::regionSize(std::size_t count) const
+{
+    assert(count <= maxPagesCount());
+
+    // One page is added for the descriptors rounding and one for the alignment of the region obtained from provider.
+    auto pagesCount = utils::divRoundUp(count * pageSize(), pageSize() - sizeof(Page)) + 2;
+    return pagesCount * pageSize();
+}
+
+std::size_t PageAllocator::decommitGroup(Page* group)
+{
+    assert(group);
+
+    // Decommitted pages are marked as zeroed, so that they are not cleared again by allocateZeroed().
+    bool zeroed = m_zeroedPages && m_provider->isZeroedAfterDecommit();
+    auto alignment = std::max(pageSize(), m_provider->decommitAlignment());
+    std::size_t decommittedCount = 0;
+    Page* end = group + group->groupSize();
+    for (auto* page = group; page != end;) {
+        if (page->isDecommitted()) {
+            page = page->nextSibling();
+            continue;
+        }
+
+        auto* runStart = page;
+        for (; page != end && !page->isDecommitted(); page = page->nextSibling()) {}
+
+        // Only the part of the run, that is aligned as demanded by the provider, can be decommitted.
+        auto runSize = static_cast<std::size_t>(page - runStart) * pageSize();
+        auto start = utils::roundUp(runStart->address(), alignment);
+        auto end = utils::roundDown(runStart->address() + runSize, alignment);
+        if (start >= end || !m_provider->decommit({start, end - start}))
+            continue;
+
+        auto* firstPage = runStart + (start - runStart->address()) / pageSize();
+        auto* lastPage = firstPage + (end - start) / pageSize();
+        for (auto* runPage = firstPage; runPage != lastPage; runPage = runPage->nextSibling()) {
+            runPage->setDecommitted(true);
+            if (zeroed)
+                runPage->setZeroed(true);
+        }
+
+        decommittedCount += static_cast<std::size_t>(lastPage - firstPage);
+    }
+
+    m_decommittedPagesCount += decommittedCount;
+    return decommittedCount;
+}
+
+void PageAllocator::commitPages(Page* pages, std::size_t count)
+{
+    assert(pages);
+
+    Page* end = pages + count;
+    for (auto* page = pages; page != end;) {
+        if (!page->isDecommitted()) {
+            page = page->nextSibling();
+            continue;
+        }
+
+        auto* runStart = page;
+        for (; page != end && page->isDecommitted(); page = page->nextSibling())
+            page->setDecommitted(false);
+
+        auto runCount = static_cast<std::size_t>(page - runStart);
+        m_decommittedPagesCount -= runCount;
+        if (m_provider != nullptr)
+            m_provider->commit({runStart->address(), runCount * pageSize()});
+    }
+}
+
+void PageAllocator::clearZeroed(Page* pages, std::size_t count)
+{
+    assert(pages);
+
+    for (auto* page = pages; page != pages + count; page = page->nextSibling())
+        page->setZeroed(false);
+}
+
+Page* PageAllocator::allocateGroup(std::size_t count)
 {
     if (m_freePagesCount < count || count == 0)
         return nullptr;
@@ -138,6 +842,7 @@ Page* PageAllocator::allocate(std::size_t count)
             if (remainingGroup != nullptr)
                 addGroup(remainingGroup);
 
+            markGroup(allocatedGroup, true);
             return allocatedGroup;
         }
     }
@@ -145,10 +850,9 @@ Page* PageAllocator::allocate(std::size_t count)
     return nullptr;
 }
 
-void PageAllocator::release(Page* pages)
+void PageAllocator::releaseGroup(Page* pages)
 {
-    if (pages == nullptr)
-        return;
+    assert(pages);
 
     Page* joinedGroup = pages;
 
@@ -188,26 +892,67 @@ void PageAllocator::release(Page* pages)
     }
     while (true);
 
+    // Region obtained from the page provider is given back, as soon as all its pages are free. One empty region is
+    // kept, so that allocations oscillating at its boundary do not obtain it from the provider over and over again.
+    auto* region = getRegion(joinedGroup->address());
+    assert(region);
+    if (region->provided && isSoleGroup(*region, joinedGroup) && !shouldKeepRegion(*region)) {
+        releaseProvidedRegion(region);
+        return;
+    }
+
     addGroup(joinedGroup);
 }
 
+bool PageAllocator::refillPageCache()
+{
+    // Single pages are taken from the smallest free groups, so that zones fill the gaps left by bigger allocations
+    // instead of breaking up the big free groups and the huge pages, that may back them.
+    auto isNotEmpty = [](Page* list) { return list != nullptr; };
+    auto list = std::find_if(m_freeGroupLists.begin(), m_freeGroupLists.end(), isNotEmpty);
+    if (list == m_freeGroupLists.end())
+        return false;
+
+    auto* freeGroup = *list;
+    removeGroup(freeGroup);
+
+    auto [group, remainingGroup] = splitGroup(freeGroup, std::min(m_cPageCacheBatchSize, freeGroup->groupSize()));
+    if (remainingGroup != nullptr)
+        addGroup(remainingGroup);
+
+    // Pages are pushed in the reverse order, so that they are handed out with the increasing addresses.
+    auto count = group->groupSize();
+    clearGroup(group);
+    for (auto i = count; i != 0; --i) {
+        auto* page = group + i - 1;
+        initGroup(page, 1);
+        markGroup(page, true);
+        page->addToList(&m_pageCache);
+    }
+
+    m_cachedPagesCount += count;
+    return true;
+}
+
+void PageAllocator::drainPageCache(std::size_t count)
+{
+    for (std::size_t i = 0; i < count && m_pageCache != nullptr; ++i) {
+        auto* page = m_pageCache;
+        page->removeFromList(&m_pageCache);
+        --m_cachedPagesCount;
+        releaseGroup(page);
+    }
+}
+
 Page* PageAllocator::getPage(std::uintptr_t addr)
 {
-    auto alignedAddr = addr & ~(m_pageSize - 1);
+    auto alignedAddr = addr & ~(pageSize() - 1);
 
     RegionInfo* pageRegion = getRegion(alignedAddr);
     if (pageRegion == nullptr)
         return nullptr;
 
-    Page* result = nullptr;
-    for (auto* page = pageRegion->firstPage; page <= pageRegion->lastPage; page = page->nextSibling()) {
-        if (page->address() == alignedAddr) {
-            result = page;
-            break;
-        }
-    }
-
-    return result;
+    return pageRegion->firstPage + (alignedAddr - pageRegion->alignedStart) / pageSize();
 }
 
 PageAllocator::Stats PageAllocator::getStats()
@@ -216,18 +961,23 @@ PageAllocator::Stats PageAllocator::getStats()
     auto* end = std::begin(m_regionsInfo) + m_validRegionsCount;
 
     Stats stats{};
-    stats.totalMemorySize = std::accumulate(start, end, 0U, [](const size_t& sum, const RegionInfo& region) {
-        return sum + region.size;
-    });
-    stats.effectiveMemorySize = std::accumulate(start, end, 0U, [](const size_t& sum, const RegionInfo& region) {
-        return sum + region.alignedSize;
-    });
+    stats.totalMemorySize =
+        std::accumulate(start, end, std::size_t{0}, [](const size_t& sum, const RegionInfo& region) {
+            return sum + region.size;
+        });
+    stats.effectiveMemorySize =
+        std::accumulate(start, end, std::size_t{0}, [](const size_t& sum, const RegionInfo& region) {
+            return sum + region.alignedSize;
+        });
     stats.userMemorySize = stats.effectiveMemorySize - (m_pageSize * m_descPagesCount);
-    stats.freeMemorySize = m_freePagesCount * m_pageSize;
+    stats.freeMemorySize = (m_freePagesCount + m_cachedPagesCount) * m_pageSize;
     stats.pageSize = m_pageSize;
     stats.totalPagesCount = m_pagesCount;
     stats.reservedPagesCount = m_descPagesCount;
-    stats.freePagesCount = m_freePagesCount;
+    stats.freePagesCount = m_freePagesCount + m_cachedPagesCount;
+    stats.cachedPagesCount = m_cachedPagesCount;
+    stats.decommittedPagesCount = m_decommittedPagesCount;
+    stats.emergencyPagesCount = m_emergencyPagesCount;
 
     return stats;
 }
@@ -277,17 +1027,24 @@ std::size_t PageAllocator::reserveDescPages()
 
 bool PageAllocator::isValidPage(Page* page)
 {
-    return (page >= m_pagesHead && page <= m_pagesTail);
+    // Descriptors of the added regions are not stored together with the others, so each region is checked.
+    for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
+        auto& region = m_regionsInfo.at(i);
+        if (page >= region.firstPage && page <= region.lastPage)
+            return true;
+    }
+
+    return false;
 }
 
 RegionInfo* PageAllocator::getRegion(std::uintptr_t addr)
 {
-    auto alignedAddr = addr & ~(m_pageSize - 1);
+    auto alignedAddr = addr & ~(pageSize() - 1);
 
     for (std::size_t i = 0; i < m_validRegionsCount; ++i) {
         auto& region = m_regionsInfo.at(i);
 
-        if (region.alignedStart <= alignedAddr && region.alignedEnd >= alignedAddr)
+        if (region.alignedStart <= alignedAddr && alignedAddr < region.alignedEnd)
             return &region;
     }
 
@@ -301,11 +1058,7 @@ void PageAllocator::addGroup(Page* group)
     std::size_t idx = groupIdx(group->groupSize());
     group->addToList(&m_freeGroupLists.at(idx));
     m_freePagesCount += group->groupSize();
-
-    for (std::size_t i = 0; i < group->groupSize(); ++i) {
-        auto* page = group + i;
-        page->setUsed(false);
-    }
+    markGroup(group, false);
 }
 
 void PageAllocator::removeGroup(Page* group)
@@ -315,11 +1068,17 @@ void PageAllocator::removeGroup(Page* group)
     std::size_t idx = groupIdx(group->groupSize());
     group->removeFromList(&m_freeGroupLists.at(idx));
     m_freePagesCount -= group->groupSize();
+    markGroup(group, true);
+}
 
-    for (std::size_t i = 0; i < group->groupSize(); ++i) {
-        auto* page = group + i;
-        page->setUsed(true);
-    }
+void PageAllocator::markGroup(Page* group, bool used)
+{
+    assert(group);
+
+    Page* firstPage = group;
+    Page* lastPage = group + group->groupSize() - 1;
+    firstPage->setUsed(used);
+    lastPage->setUsed(used);
 }
 
 } // namespace memory
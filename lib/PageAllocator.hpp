@@ -35,6 +35,9 @@
 #include "RegionInfo.hpp"
 #include "utils.hpp"
 
+#include <allocator/allocator.hpp>
+#include <allocator/config.hpp>
+
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -42,6 +45,7 @@
 namespace memory {
 
 class Page;
+class PageProvider;
 struct Region;
 
 /// Represents an allocator of physical pages.
@@ -49,14 +53,17 @@ class PageAllocator {
 public:
     /// Represents the statistical data of the PageAllocator.
     struct Stats {
-        std::size_t totalMemorySize;     ///< Total size of the memory passed during initialization.
-        std::size_t effectiveMemorySize; ///< Effective size of the memory, that can be used by the PageAllocator.
-        std::size_t userMemorySize;      ///< Total size of the memory available to the user.
-        std::size_t freeMemorySize;      ///< Size of the remaining user memory.
-        std::size_t pageSize;            ///< Size of the page used by the PageAllocator.
-        std::size_t totalPagesCount;     ///< Total number of the pages known to the PageAllocator.
-        std::size_t reservedPagesCount;  ///< Number of pages reserved for the PageAllocator.
-        std::size_t freePagesCount;      ///< Current number of the free pages.
+        std::size_t totalMemorySize;       ///< Total size of the memory passed during initialization.
+        std::size_t effectiveMemorySize;   ///< Effective size of the memory, that can be used by the PageAllocator.
+        std::size_t userMemorySize;        ///< Total size of the memory available to the user.
+        std::size_t freeMemorySize;        ///< Size of the remaining user memory.
+        std::size_t pageSize;              ///< Size of the page used by the PageAllocator.
+        std::size_t totalPagesCount;       ///< Total number of the pages known to the PageAllocator.
+        std::size_t reservedPagesCount;    ///< Number of pages reserved for the PageAllocator.
+        std::size_t freePagesCount;        ///< Current number of the free pages.
+        std::size_t cachedPagesCount;      ///< Number of the free pages, that are held in the single page cache.
+        std::size_t decommittedPagesCount; ///< Number of the free pages, whose memory is given back to the system.
+        std::size_t emergencyPagesCount;   ///< Number of the free pages, that only critical allocations can use.
     };
 
     /// Default constructor.
@@ -65,31 +72,148 @@ public:
     /// Initializes the PageAllocator with the given memory model.
     /// @param regions          Array of memory regions to be used by PageAllocator. Last entry should be zeroed.
     /// @param pageSize         Size of the page on the current platform.
+    /// @param zeroed           Flag indicating if the given regions are known to contain only zeros.
     /// @return Result of the initialization.
     /// @retval true            PageAllocator has been initialized.
     /// @retval false           Some error occurred.
-    [[nodiscard]] bool init(Region* regions, std::size_t pageSize);
+    [[nodiscard]] bool init(Region* regions, std::size_t pageSize, bool zeroed = false);
+
+    /// Adds the given memory region to the already initialized PageAllocator.
+    /// @param region           Memory region to be added.
+    /// @param zeroed           Flag indicating if the given region is known to contain only zeros.
+    /// @return Result of the operation.
+    /// @retval true            Region has been added.
+    /// @retval false           PageAllocator is not initialized, region is too small, overlaps with a known region or
+    ///                         there is no free region slot.
+    /// @note Page descriptors of the added region are stored at its beginning.
+    [[nodiscard]] bool addRegion(const Region& region, bool zeroed = false);
+
+    /// Sets the page provider, that is asked for new regions, when there are not enough free pages.
+    /// @param provider         Page provider to be used or nullptr to disable growing.
+    /// @param directThreshold  Minimal size of the allocation, which is served from a dedicated region obtained from
+    ///                         the provider. Value 0 disables direct allocations.
+    /// @note Each region obtained from the provider is as big as all non-dedicated regions known so far. Regions
+    ///       obtained from the provider are given back to it, as soon as all their pages are released, except of one
+    ///       empty region, which is kept until trim().
+    void setProvider(PageProvider* provider, std::size_t directThreshold = 0);
+
+    /// Sets the size of the free memory, that triggers decommit of all free pages through the page provider.
+    /// @param threshold        Size of the free committed memory, above which free pages are decommitted on release.
+    ///                         Value 0 disables the automatic decommit.
+    /// @note Free memory, that the provider failed to decommit, does not count towards the threshold.
+    void setDecommitThreshold(std::size_t threshold);
+
+    /// Gives the empty regions and the physical memory of all free pages back to the system through the page provider.
+    /// @return Size of the memory, that has been given back.
+    /// @note Decommitted pages are committed again only when they are allocated. Pages, that are already decommitted,
+    ///       are skipped, so the cost of this function is proportional to the number of the free pages.
+    std::size_t trim();
+
+    /// Sets the watermarks of the free memory, that control calling of the shrinkers.
+    /// @param low              Size of the free memory, below which shrinkers are called after an allocation.
+    ///                         Value 0 disables it. Shrinkers are called again only after free memory reaches high.
+    /// @param high             Size of the free memory, that the shrinkers are asked to restore.
+    /// @note Shrinkers are always called, before an allocation fails.
+    /// @note Drop below the low watermark only arms the reclaim, which is run by reclaimPending().
+    void setWatermarks(std::size_t low, std::size_t high);
+
+    /// Calls the shrinkers, if an allocation has dropped the free memory below the low watermark.
+    /// @note Pages are allocated in the middle of the operations of the upper layers, which are not ready to be
+    ///       entered by the shrinkers, so this function has to be called after the outermost allocation finishes.
+    void reclaimPending();
+
+    /// Registers the given shrinker, that is asked to release memory, when the free memory runs low.
+    /// @param shrinker         Shrinker to be registered.
+    /// @return Flag indicating if the shrinker has been registered.
+    /// @retval true            Shrinker has been registered.
+    /// @retval false           Shrinker is invalid or there is no free shrinker slot.
+    [[nodiscard]] bool addShrinker(const allocator::Shrinker& shrinker);
+
+    /// Unregisters the given shrinker.
+    /// @param shrinker         Shrinker to be unregistered.
+    void removeShrinker(const allocator::Shrinker& shrinker);
+
+    /// Sets the size of the emergency reserve, that only critical allocations can use.
+    /// @param size             Size of the reserve. It is rounded up to the page size. Value 0 disables the reserve.
+    /// @note Reserve is the number of free pages, that normal allocations have to leave, not a dedicated set of pages.
+    void setEmergencyReserve(std::size_t size);
+
+    /// Allows or forbids the following allocations to use the emergency reserve.
+    /// @param unlocked         Flag indicating if the emergency reserve can be used.
+    void setReserveUnlocked(bool unlocked);
+
+    /// Gives all regions obtained from the page provider back to it and clears the internal state of the PageAllocator.
+    /// @note All pages from the provided regions become invalid, so the PageAllocator has to be initialized again.
+    void releaseProvidedRegions();
 
     /// Clears the internal state of the PageAllocator.
+    /// @note Regions obtained from the page provider are not given back to it. Use releaseProvidedRegions() for that.
     void clear();
 
+    /// Releases all allocated pages at once, while keeping the memory model passed during initialization.
+    /// @note This function works in time proportional to the number of regions, not to the number of allocations.
+    /// @note Pages, that were never allocated, are still known to contain only zeros after the reset.
+    void reset();
+
     /// Allocates the given number of physical pages.
     /// @param count            Number of pages to be allocated.
     /// @return Result of the allocation.
     /// @retval Page*           A set of allocated pages on success.
     /// @retval nullptr         Some error occurred.
     /// @note All allocated pages must be from the same region.
+    /// @note Single pages are served from the page cache, which is refilled in batches from the free groups.
     [[nodiscard]] Page* allocate(std::size_t count);
 
+    /// Allocates the given number of physical pages and fills them with zeros.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    /// @note Only pages, that are not known to contain zeros, are cleared.
+    [[nodiscard]] Page* allocateZeroed(std::size_t count);
+
+    /// Allocates the given number of physical pages, whose address is aligned to the given alignment.
+    /// @param count            Number of pages to be allocated.
+    /// @param alignment        Demanded alignment of the first page. It must be a power of 2.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    /// @note Alignments bigger than the page size are served by allocating more pages and releasing the unaligned head
+    ///       and the tail of the set.
+    [[nodiscard]] Page* allocateAligned(std::size_t count, std::size_t alignment);
+
     /// Releases the given set of pages.
     /// @param pages            List of pages to be released.
+    /// @note Single pages are returned to the page cache, which is drained in batches to the free groups.
     void release(Page* pages);
 
+    /// Changes the size of the given set of pages in place.
+    /// @param pages            Set of pages to be resized.
+    /// @param count            Demanded number of pages.
+    /// @return Result of the resize.
+    /// @retval true            Set of pages has been resized and still starts at the same page.
+    /// @retval false           There are not enough free pages directly after the given set of pages.
+    /// @note Growing joins the set with the following free group. Shrinking releases the tail of the set.
+    [[nodiscard]] bool resize(Page* pages, std::size_t count);
+
+    /// Moves the given set of pages, that fills the whole region obtained from the page provider, into the new region
+    /// with the given number of pages.
+    /// @param pages            Set of pages to be moved.
+    /// @param count            Demanded number of pages.
+    /// @return Result of the operation.
+    /// @retval Page*           Moved set of pages. Its content is preserved up to the lesser of the sizes.
+    /// @retval nullptr         Set of pages is not a direct allocation or the provider cannot move it. The given set
+    ///                         of pages is left untouched.
+    /// @note Content is moved by the page provider (e.g. with mremap()), so no bytes are copied. The old region is
+    ///       given back to the provider, so its pages become invalid.
+    [[nodiscard]] Page* remap(Page* pages, std::size_t count);
+
     /// Returns the Page, which contains the given address.
     /// @param addr             Address for which Page should be found.
     /// @return Result of the check.
     /// @retval Page*           Pointer to Page containing given address if found.
     /// @retval nullptr         There is no page with the given address.
+    /// @note This function works in constant time, because page descriptors of each region are stored in order.
     Page* getPage(std::uintptr_t addr);
 
     /// Returns the current statistics of PageAllocator.
@@ -105,6 +229,148 @@ public:
     }
 
 private:
+    /// Allocates the given number of physical pages either from the page cache or from the free groups.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    /// @note Zeroed flags of the allocated pages are not modified.
+    Page* allocatePages(std::size_t count);
+
+    /// Allocates the given number of physical pages from the regions, that are already known.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    Page* allocateKnown(std::size_t count);
+
+    /// Allocates the given number of physical pages from a dedicated region obtained from the page provider.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    /// @note All pages of the region are allocated, so that none of them can pin the region with other allocations.
+    Page* allocateDirect(std::size_t count);
+
+    /// Obtains a new region from the page provider, that can hold at least the given number of pages.
+    /// @param count            Number of pages, that the new region should hold.
+    /// @return Flag indicating if the new region has been added.
+    /// @retval true            New region has been added.
+    /// @retval false           Some error occurred.
+    bool grow(std::size_t count);
+
+    /// Allocates the given number of physical pages from the known regions, if it does not break into the reserve.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred or allocation would use the locked emergency reserve.
+    Page* allocateAvailable(std::size_t count);
+
+    /// Calls the shrinkers in the order of registration, until the free memory reaches the given size.
+    /// @param size             Demanded size of the free memory.
+    /// @param count            Number of pages to be allocated after each shrinker or 0 if nothing should be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Nothing was supposed to be allocated or shrinkers have not released enough memory.
+    /// @note Shrinkers are not called recursively, when they allocate memory.
+    Page* reclaim(std::size_t size, std::size_t count);
+
+    /// Returns the size of the free memory, including the page cache.
+    /// @return Size of the free memory.
+    [[nodiscard]] std::size_t freeMemorySize() const { return (m_freePagesCount + m_cachedPagesCount) * pageSize(); }
+
+    /// Obtains the region with the given size from the page provider and adds it.
+    /// @param size             Size of the region to be obtained.
+    /// @return Result of the operation.
+    /// @retval RegionInfo*     Added region on success.
+    /// @retval nullptr         Some error occurred.
+    RegionInfo* addProvidedRegion(std::size_t size);
+
+    /// Removes the given region obtained from the page provider and gives it back.
+    /// @param region           Region to be removed. None of its pages can be in the free groups or in the page cache.
+    void releaseProvidedRegion(RegionInfo* region);
+
+    /// Checks if all pages of the given region are free.
+    /// @param region           Region to be checked.
+    /// @return Flag indicating if the given region is empty.
+    /// @retval true            All pages of the region form one free group.
+    /// @retval false           Some pages of the region are used or are kept in the page cache.
+    [[nodiscard]] bool isEmptyRegion(const RegionInfo& region) const;
+
+    /// Checks if the given group covers all pages of the region except of the descriptors and the spare pages.
+    /// @param region           Region to be checked.
+    /// @param group            Group, that lies in the given region.
+    /// @return Flag indicating if the given group is the only one in the region.
+    /// @retval true            Group covers all pages of the region, that can be handed out.
+    /// @retval false           Region contains also other groups.
+    [[nodiscard]] bool isSoleGroup(const RegionInfo& region, Page* group) const;
+
+    /// Checks if the given provided region, that has just become empty, should be kept instead of being given back.
+    /// @param region           Region to be checked.
+    /// @return Flag indicating if the given region should be kept.
+    /// @retval true            Region is not dedicated and no other empty region obtained from the provider is kept.
+    /// @retval false           Region should be given back to the provider.
+    [[nodiscard]] bool shouldKeepRegion(const RegionInfo& region) const;
+
+    /// Sets the size of the next region obtained from the provider to the size of the memory known so far.
+    void updateGrowSize();
+
+    /// Returns the maximal number of pages, that can be allocated at once.
+    /// @return Maximal number of pages in one allocation or in one region obtained from the provider.
+    /// @note Limit keeps the size of every group within its descriptor and the region sizes within std::size_t.
+    [[nodiscard]] std::size_t maxPagesCount() const;
+
+    /// Limits the given region to the number of pages, that can be described by a single group.
+    /// @param regionInfo       Region info to be limited.
+    /// @param pageSize         Size of the physical page.
+    static void limitRegionInfo(RegionInfo& regionInfo, std::size_t pageSize);
+
+    /// Returns the size of the region, that can hold the given number of pages together with their descriptors.
+    /// @param count            Number of pages, that the region should hold.
+    /// @return Size of the region.
+    [[nodiscard]] std::size_t regionSize(std::size_t count) const;
+
+    /// Gives the physical memory of all free pages back to the system through the page provider.
+    /// @return Size of the memory, that has been decommitted.
+    /// @note Empty regions are not given back here, so that the automatic decommit does not make the heap shrink.
+    std::size_t decommitFreePages();
+
+    /// Decommits all committed pages from the given free group through the page provider.
+    /// @param group            Free group to be decommitted.
+    /// @return Number of pages, that have been decommitted.
+    std::size_t decommitGroup(Page* group);
+
+    /// Commits again all decommitted pages in the given set of pages, that is being handed out.
+    /// @param pages            Set of pages to be committed.
+    /// @param count            Number of pages in the set.
+    void commitPages(Page* pages, std::size_t count);
+
+    /// Clears the 'zeroed' flag of all pages in the given set of pages, that is being handed out.
+    /// @param pages            Set of pages to be marked.
+    /// @param count            Number of pages in the set.
+    void clearZeroed(Page* pages, std::size_t count);
+
+    /// Allocates the given number of physical pages directly from the free groups.
+    /// @param count            Number of pages to be allocated.
+    /// @return Result of the allocation.
+    /// @retval Page*           A set of allocated pages on success.
+    /// @retval nullptr         Some error occurred.
+    Page* allocateGroup(std::size_t count);
+
+    /// Releases the given set of pages directly to the free groups and joins it with its free neighbours.
+    /// @param pages            List of pages to be released.
+    void releaseGroup(Page* pages);
+
+    /// Moves a batch of pages from the free groups to the page cache.
+    /// @return Flag indicating if any page has been moved to the page cache.
+    /// @retval true            Page cache has been refilled.
+    /// @retval false           There are no free pages left in the free groups.
+    bool refillPageCache();
+
+    /// Moves the given number of pages from the page cache back to the free groups.
+    /// @param count            Number of pages to be moved.
+    void drainPageCache(std::size_t count);
+
     /// Returns the total number of pages from all known regions.
     /// @return Number of all pages from all known regions.
     std::size_t countPages();
@@ -139,9 +405,27 @@ private:
     /// @param group            Group to be removed.
     void removeGroup(Page* group);
 
+    /// Returns size of the page.
+    /// @return Size of the page.
+    /// @note If the page size is fixed at compile time, then all calculations based on it are folded by the compiler.
+    [[nodiscard]] std::size_t pageSize() const { return config::pageSize(m_pageSize); }
+
+    /// Sets the 'used' flag of the given group to the given state.
+    /// @param group            Group to be marked.
+    /// @param used             State to be set.
+    void markGroup(Page* group, bool used);
+
 private:
-    static constexpr int m_cMaxRegionsCount = 8; ///< Maximal supported number of memory regions.
-    static constexpr int m_cMaxGroupIdx = 20;    ///< Maximal index of the group in the free array.
+    static constexpr std::size_t m_cMaxRegionsCount = config::cMaxRegionsCount; ///< Maximal number of memory regions.
+    static constexpr int m_cMaxGroupIdx = 20; ///< Maximal index of the group in the free array.
+    static constexpr std::size_t m_cMaxPagesCount = std::size_t(1) << m_cMaxGroupIdx; ///< Maximal pages at once.
+    static constexpr std::size_t m_cMaxRegionPagesCount = 2 * m_cMaxPagesCount - 1;   ///< Maximal pages in a group.
+
+    static constexpr std::size_t m_cPageCacheBatchSize = 8;                          ///< Pages moved at once.
+    static constexpr std::size_t m_cMaxCachedPagesCount = 2 * m_cPageCacheBatchSize; ///< Page cache drain threshold.
+    static constexpr std::size_t m_cMaxShrinkersCount = 8;                           ///< Number of shrinker slots.
+
+    using Shrinkers = std::array<allocator::Shrinker, m_cMaxShrinkersCount>; ///< Array of the shrinker slots.
 
 private:
     std::array<RegionInfo, m_cMaxRegionsCount> m_regionsInfo{}; ///< Array describing all known regions.
@@ -153,7 +437,25 @@ private:
     Page* m_pagesTail{};                                        ///< Tail of the page descriptors list.
     std::array<Page*, m_cMaxGroupIdx> m_freeGroupLists{};       ///< Array of the groups with free pages.
     std::size_t m_pagesCount{};                                 ///< Total number of pages known to the PageAllocator.
-    std::size_t m_freePagesCount{};                             ///< Current number of free pages.
+    std::size_t m_freePagesCount{};                             ///< Current number of free pages in the free groups.
+    Page* m_pageCache{};                                        ///< List of the free single pages ready to be used.
+    std::size_t m_cachedPagesCount{};                           ///< Current number of pages in the page cache.
+    bool m_zeroedPages{};                                       ///< Flag indicating if zeroed pages are tracked.
+    PageProvider* m_provider{};                                 ///< Source of the new regions.
+    std::size_t m_directThreshold{};                            ///< Minimal size of the direct allocation.
+    std::size_t m_growSize{};                                   ///< Size of the next region obtained from provider.
+    std::size_t m_decommitThreshold{};                          ///< Size of free memory, that triggers trim().
+    std::size_t m_decommittedPagesCount{};                      ///< Current number of the decommitted free pages.
+    std::size_t m_retainedPagesCount{};                         ///< Free pages not decommitted by the last trim().
+    std::size_t m_lowWatermark{};                               ///< Size of free memory, that triggers shrinkers.
+    std::size_t m_highWatermark{};                              ///< Size of free memory restored by shrinkers.
+    bool m_reclaimArmed{};                                      ///< Flag indicating if low watermark is active.
+    bool m_reclaimPending{};                                    ///< Flag indicating if shrinkers should be called.
+    bool m_reclaiming{};                                        ///< Flag indicating if shrinkers are being called.
+    bool m_reserveUnlocked{};                                   ///< Flag indicating if the reserve can be used.
+    Shrinkers m_shrinkers{};                                    ///< Registered shrinkers.
+    std::size_t m_shrinkersCount{};                             ///< Number of the registered shrinkers.
+    std::size_t m_emergencyPagesCount{};                        ///< Number of free pages kept for critical allocations.
 };
 
 namespace detail {
@@ -163,9 +465,13 @@ namespace detail {
 /// @return Flag indicating if the page size has a proper value.
 /// @retval true                Page size is valid.
 /// @retval false               Page size is invalid.
-/// @note This function checks if pageSize has the minimal size and if is a power of 2.
+/// @note This function checks if pageSize has the minimal size and if is a power of 2. If the page size is fixed at
+///       compile time, then only that value is valid.
 inline bool isValidPageSize(std::size_t pageSize)
 {
+    if (config::cPageSize != 0 && pageSize != config::cPageSize)
+        return false;
+
     return (pageSize >= PageAllocator::minimalPageSize() && utils::isPowerOf2(pageSize));
 }
 
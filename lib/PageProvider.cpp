@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+#include <allocator/PageProvider.hpp>
+
+#include <cassert>
+
+namespace memory {
+
+StaticPageProvider::StaticPageProvider(std::uintptr_t start, std::uintptr_t end) noexcept
+    : m_cursor(start)
+    , m_end(end)
+{
+    assert(start <= end);
+}
+
+Region StaticPageProvider::allocate(std::size_t size)
+{
+    if (size == 0)
+        return {0, 0};
+
+    for (std::size_t i = 0; i < m_slotsCount; ++i) {
+        auto& slot = m_slots.at(i);
+        if (!slot.used && slot.region.size >= size) {
+            slot.used = true;
+            return slot.region;
+        }
+    }
+
+    if (m_slotsCount == m_slots.size() || size > m_end - m_cursor)
+        return {0, 0};
+
+    Region region{m_cursor, size};
+    m_slots.at(m_slotsCount++) = {region, true};
+    m_cursor += size;
+    return region;
+}
+
+void StaticPageProvider::release(const Region& region)
+{
+    for (std::size_t i = 0; i < m_slotsCount; ++i) {
+        auto& slot = m_slots.at(i);
+        if (slot.region.address == region.address) {
+            assert(slot.used);
+            slot.used = false;
+            break;
+        }
+    }
+
+    // Free regions at the end of the pool are merged back into it.
+    while (m_slotsCount != 0 && !m_slots.at(m_slotsCount - 1).used) {
+        m_cursor = m_slots.at(m_slotsCount - 1).region.address;
+        m_slots.at(--m_slotsCount) = {};
+    }
+}
+
+std::size_t StaticPageProvider::remainingSize() const
+{
+    return m_end - m_cursor;
+}
+
+} // namespace memory
@@ -51,6 +51,10 @@ void clearRegionInfo(RegionInfo& regionInfo)
     regionInfo.alignedSize = 0;
     regionInfo.firstPage = nullptr;
     regionInfo.lastPage = nullptr;
+    regionInfo.descPagesCount = 0;
+    regionInfo.provided = false;
+    regionInfo.direct = false;
+    regionInfo.sparePages = nullptr;
 }
 
 bool initRegionInfo(RegionInfo& regionInfo, const Region& region, std::size_t pageSize)
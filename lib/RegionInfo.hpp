@@ -52,6 +52,10 @@ struct RegionInfo {
     std::size_t alignedSize;     ///< Size of the aligned part of the region.
     Page* firstPage;             ///< Pointer to the first page in the region.
     Page* lastPage;              ///< Pointer to the last page in the region.
+    std::size_t descPagesCount;  ///< Number of pages in this region used to store the page descriptors.
+    bool provided;               ///< Flag indicating if this region was obtained from the page provider.
+    bool direct;                 ///< Flag indicating if this region is dedicated to a single allocation.
+    Page* sparePages;            ///< Pages of the dedicated region, that are not part of its allocation.
 };
 
 /// Clears the contents of the region info.
@@ -0,0 +1,370 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include "utils.hpp"
+
+#include <allocator/SharedHeap.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <new>
+
+namespace memory {
+
+SharedHeap* SharedHeap::create(void* memory, std::size_t size)
+{
+    auto addr = reinterpret_cast<std::uintptr_t>(memory);
+    if (memory == nullptr || addr % m_cAlignment != 0)
+        return nullptr;
+
+    size = utils::roundDown(size, m_cAlignment);
+    if (size < utils::roundUp(sizeof(SharedHeap), m_cAlignment) + m_cMinBlockSize)
+        return nullptr;
+
+    return new (memory) SharedHeap(size);
+}
+
+SharedHeap* SharedHeap::attach(void* memory, std::size_t size)
+{
+    auto* heap = find(memory, size);
+    if (heap == nullptr)
+        return nullptr;
+
+    heap->lock();
+    ++heap->m_attachedCount;
+    heap->unlock();
+    return heap;
+}
+
+SharedHeap* SharedHeap::recover(void* memory, std::size_t size)
+{
+    auto* heap = find(memory, size);
+    if (heap == nullptr)
+        return nullptr;
+
+    // Nonzero number of attached processes means, that some of them died, possibly in the middle of an operation.
+    if (heap->m_attachedCount != 0) {
+        heap->m_lock.clear(std::memory_order_relaxed);
+        if (!heap->rebuild())
+            return nullptr;
+
+        heap->m_attachedCount = 0;
+    }
+
+    ++heap->m_attachedCount;
+    return heap;
+}
+
+void SharedHeap::detach()
+{
+    lock();
+    assert(m_attachedCount != 0);
+    --m_attachedCount;
+    unlock();
+}
+
+std::size_t SharedHeap::attachedCount()
+{
+    lock();
+    auto count = m_attachedCount;
+    unlock();
+
+    return count;
+}
+
+void SharedHeap::setRoot(Offset offset)
+{
+    lock();
+    m_root = offset;
+    unlock();
+}
+
+SharedHeap::Offset SharedHeap::root()
+{
+    lock();
+    auto offset = m_root;
+    unlock();
+
+    return offset;
+}
+
+void* SharedHeap::allocate(std::size_t size)
+{
+    if (size == 0 || size > m_size)
+        return nullptr;
+
+    auto blockSize = std::max(utils::roundUp(size + sizeof(Block), m_cAlignment), m_cMinBlockSize);
+
+    lock();
+    auto offset = takeFreeBlock(blockSize);
+    if (offset == 0) {
+        unlock();
+        return nullptr;
+    }
+
+    // Tail of the found block is given back to the free lists, if it can hold a block on its own.
+    auto foundSize = block(offset)->size;
+    if (foundSize - blockSize >= m_cMinBlockSize) {
+        auto rest = offset + blockSize;
+        block(rest)->size = foundSize - blockSize;
+        block(rest)->prevSize = blockSize;
+        updateNextBlock(rest);
+        addToFreeList(rest);
+    }
+    else {
+        blockSize = foundSize;
+    }
+
+    publishSize(offset, blockSize | m_cUsedFlag);
+    m_freeSize -= blockSize;
+    unlock();
+
+    return utils::movePtr(block(offset), sizeof(Block));
+}
+
+void SharedHeap::release(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    auto offset = toOffset(ptr) - sizeof(Block);
+    assert((block(offset)->size & m_cUsedFlag) != 0);
+
+    lock();
+    auto size = block(offset)->size & ~m_cUsedFlag;
+    m_freeSize += size;
+
+    // Neighbors of a free block are never free, so coalescing has to look only one block in each direction.
+    if (auto next = offset + size; next < m_size && (block(next)->size & m_cUsedFlag) == 0) {
+        removeFromFreeList(next);
+        size += block(next)->size;
+    }
+
+    if (auto prevSize = block(offset)->prevSize; prevSize != 0 && (block(offset - prevSize)->size & m_cUsedFlag) == 0) {
+        offset -= prevSize;
+        removeFromFreeList(offset);
+        size += block(offset)->size;
+    }
+
+    publishSize(offset, size);
+    updateNextBlock(offset);
+    addToFreeList(offset);
+    unlock();
+}
+
+std::size_t SharedHeap::usableSize(void* ptr) const
+{
+    assert(ptr);
+    auto offset = toOffset(ptr) - sizeof(Block);
+    return (block(offset)->size & ~m_cUsedFlag) - sizeof(Block);
+}
+
+SharedHeap::Offset SharedHeap::toOffset(const void* ptr) const
+{
+    if (ptr == nullptr)
+        return 0;
+
+    return reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(this);
+}
+
+void* SharedHeap::fromOffset(Offset offset) const
+{
+    if (offset == 0)
+        return nullptr;
+
+    auto addr = reinterpret_cast<std::uintptr_t>(this) + offset;
+    return reinterpret_cast<void*>(addr); // NOLINT(performance-no-int-to-ptr)
+}
+
+allocator::Stats SharedHeap::getStats()
+{
+    allocator::Stats stats{};
+    auto reservedSize = utils::roundUp(sizeof(SharedHeap), m_cAlignment);
+
+    lock();
+    stats.totalMemorySize = m_size;
+    stats.reservedMemorySize = reservedSize;
+    stats.userMemorySize = m_size - reservedSize;
+    stats.freeMemorySize = m_freeSize;
+    stats.allocatedMemorySize = stats.userMemorySize - stats.freeMemorySize;
+    unlock();
+
+    return stats;
+}
+
+SharedHeap::SharedHeap(std::size_t size)
+    : m_size(size)
+{
+    auto offset = utils::roundUp(sizeof(SharedHeap), m_cAlignment);
+    block(offset)->size = size - offset;
+    block(offset)->prevSize = 0;
+    addToFreeList(offset);
+    m_freeSize = size - offset;
+    m_attachedCount = 1;
+
+    // Marker is set at the end, so that the heap is never attached in the partially initialized state.
+    std::atomic_signal_fence(std::memory_order_release);
+    m_magic = m_cMagic;
+}
+
+SharedHeap* SharedHeap::find(void* memory, std::size_t size)
+{
+    auto addr = reinterpret_cast<std::uintptr_t>(memory);
+    if (memory == nullptr || addr % m_cAlignment != 0 || size < sizeof(SharedHeap))
+        return nullptr;
+
+    // Heap recorded as bigger than the mapping would let every block access run past its end.
+    auto* heap = std::launder(reinterpret_cast<SharedHeap*>(memory));
+    if (heap->m_magic != m_cMagic || heap->m_size > size)
+        return nullptr;
+
+    return heap;
+}
+
+void SharedHeap::lock()
+{
+    while (m_lock.test_and_set(std::memory_order_acquire)) {
+        while (m_lock.test(std::memory_order_relaxed)) {}
+    }
+}
+
+void SharedHeap::unlock()
+{
+    m_lock.clear(std::memory_order_release);
+}
+
+SharedHeap::Block* SharedHeap::block(Offset offset) const
+{
+    assert(offset != 0 && offset + sizeof(Block) <= m_size);
+    return static_cast<Block*>(fromOffset(offset));
+}
+
+SharedHeap::FreeLinks* SharedHeap::links(Offset offset) const
+{
+    return static_cast<FreeLinks*>(fromOffset(offset + sizeof(Block)));
+}
+
+void SharedHeap::addToFreeList(Offset offset)
+{
+    auto& head = m_freeLists[utils::log2(block(offset)->size)];
+    links(offset)->next = head;
+    links(offset)->prev = 0;
+    if (head != 0)
+        links(head)->prev = offset;
+
+    head = offset;
+}
+
+void SharedHeap::removeFromFreeList(Offset offset)
+{
+    auto& head = m_freeLists[utils::log2(block(offset)->size)];
+    auto* node = links(offset);
+    if (node->prev != 0)
+        links(node->prev)->next = node->next;
+    else
+        head = node->next;
+
+    if (node->next != 0)
+        links(node->next)->prev = node->prev;
+}
+
+SharedHeap::Offset SharedHeap::takeFreeBlock(std::size_t size)
+{
+    // Blocks in the first list may be smaller than demanded, while the first block of any following list is big enough.
+    auto idx = utils::log2(size);
+    Offset offset = 0;
+    for (auto it = m_freeLists[idx]; it != 0 && offset == 0; it = links(it)->next) {
+        if (block(it)->size >= size)
+            offset = it;
+    }
+
+    for (++idx; idx < m_cFreeListsCount && offset == 0; ++idx)
+        offset = m_freeLists[idx];
+
+    if (offset != 0)
+        removeFromFreeList(offset);
+
+    return offset;
+}
+
+void SharedHeap::publishSize(Offset offset, Offset size)
+{
+    // Stores, that a killed process has already executed, are never lost, so only the compiler has to be kept from
+    // moving the preceding stores of the operation after the size word trusted by rebuild().
+    std::atomic_signal_fence(std::memory_order_release);
+    block(offset)->size = size;
+}
+
+void SharedHeap::updateNextBlock(Offset offset)
+{
+    auto size = block(offset)->size & ~m_cUsedFlag;
+    if (offset + size < m_size)
+        block(offset + size)->prevSize = size;
+}
+
+bool SharedHeap::rebuild()
+{
+    // Sizes of the blocks are updated last by every operation, so they are trusted, while everything else is derived.
+    auto first = utils::roundUp(sizeof(SharedHeap), m_cAlignment);
+    Offset prev = 0;
+    for (auto offset = first; offset < m_size;) {
+        auto size = block(offset)->size & ~m_cUsedFlag;
+        if (size < m_cMinBlockSize || size % m_cAlignment != 0 || size > m_size - offset)
+            return false;
+
+        bool used = (block(offset)->size & m_cUsedFlag) != 0;
+        if (!used && prev != 0 && (block(prev)->size & m_cUsedFlag) == 0) {
+            block(prev)->size += size;
+        }
+        else {
+            block(offset)->prevSize = (prev != 0) ? offset - prev : 0;
+            prev = offset;
+        }
+
+        offset += size;
+    }
+
+    m_freeLists.fill(0);
+    m_freeSize = 0;
+    for (auto offset = first; offset < m_size; offset += block(offset)->size & ~m_cUsedFlag) {
+        if ((block(offset)->size & m_cUsedFlag) != 0)
+            continue;
+
+        addToFreeList(offset);
+        m_freeSize += block(offset)->size;
+    }
+
+    return true;
+}
+
+} // namespace memory
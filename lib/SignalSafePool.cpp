@@ -0,0 +1,225 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <allocator/Heap.hpp>
+#include <allocator/SignalSafePool.hpp>
+#include <allocator/allocator.hpp>
+
+#include <cassert>
+#include <new>
+
+namespace memory {
+
+SignalSafePool::SignalSafePool(Heap& heap) noexcept
+    : m_heap(&heap)
+{}
+
+SignalSafePool::~SignalSafePool()
+{
+    clear();
+}
+
+bool SignalSafePool::init(std::size_t maxSize, std::size_t blocksCount)
+{
+    clear();
+
+    auto poolsCount = allocator::sizeClass(maxSize) + 1;
+    if (maxSize == 0 || poolsCount > m_pools.size() || blocksCount == 0 || blocksCount >= m_cIndexMask)
+        return false;
+
+    for (std::size_t i = 0; i < poolsCount; ++i) {
+        auto* slots = static_cast<Slot*>(m_heap->allocate(blocksCount * sizeof(Slot)));
+        if (slots == nullptr) {
+            clear();
+            return false;
+        }
+
+        auto& pool = m_pools[i];
+        pool.slots = slots;
+        for (std::uint32_t idx = 1; idx <= blocksCount; ++idx) {
+            new (&slots[idx - 1]) Slot{};
+            push(pool.empty, slots, idx);
+        }
+
+        m_poolsCount = i + 1;
+    }
+
+    m_blocksCount = blocksCount;
+    refill();
+    return true;
+}
+
+void SignalSafePool::clear()
+{
+    for (std::size_t i = 0; i < m_poolsCount; ++i) {
+        auto& pool = m_pools[i];
+        for (auto* block = pool.overflow.exchange(nullptr); block != nullptr;) {
+            auto* next = *static_cast<void**>(block);
+            m_heap->releaseSizeClass(block, i);
+            block = next;
+        }
+
+        for (auto idx = pop(pool.ready, pool.slots); idx != 0; idx = pop(pool.ready, pool.slots))
+            m_heap->releaseSizeClass(pool.slots[idx - 1].block, i);
+
+        m_heap->release(pool.slots);
+        pool.slots = nullptr;
+        pool.ready = 0;
+        pool.empty = 0;
+        pool.count = 0;
+    }
+
+    m_poolsCount = 0;
+    m_blocksCount = 0;
+}
+
+void* SignalSafePool::allocate(std::size_t size)
+{
+    auto* pool = findPool(size);
+    if (pool == nullptr)
+        return nullptr;
+
+    auto idx = pop(pool->ready, pool->slots);
+    if (idx == 0)
+        return nullptr;
+
+    // Popped slot is owned exclusively until it is pushed again, so its block can be read without synchronization.
+    auto* block = pool->slots[idx - 1].block;
+    pool->count.fetch_sub(1, std::memory_order_relaxed);
+    push(pool->empty, pool->slots, idx);
+    return block;
+}
+
+void SignalSafePool::release(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    auto* pool = findPool(size);
+    assert(pool);
+
+    auto idx = pop(pool->empty, pool->slots);
+    if (idx == 0) {
+        // Blocks are only pushed here and the whole list is taken at once, so the list is not prone to ABA.
+        auto& overflow = pool->overflow;
+        auto* head = overflow.load(std::memory_order_relaxed);
+        do {
+            *static_cast<void**>(ptr) = head;
+        } while (!overflow.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+
+        return;
+    }
+
+    pool->slots[idx - 1].block = ptr;
+    pool->count.fetch_add(1, std::memory_order_relaxed);
+    push(pool->ready, pool->slots, idx);
+}
+
+void SignalSafePool::refill()
+{
+    for (std::size_t i = 0; i < m_poolsCount; ++i) {
+        auto& pool = m_pools[i];
+
+        // Blocks released, when the pool was full, are used first and only the remaining ones go back to the heap.
+        auto* block = pool.overflow.exchange(nullptr, std::memory_order_acquire);
+        while (block != nullptr) {
+            auto* next = *static_cast<void**>(block);
+            if (auto idx = pop(pool.empty, pool.slots); idx != 0) {
+                pool.slots[idx - 1].block = block;
+                pool.count.fetch_add(1, std::memory_order_relaxed);
+                push(pool.ready, pool.slots, idx);
+            }
+            else {
+                m_heap->releaseSizeClass(block, i);
+            }
+
+            block = next;
+        }
+
+        for (auto idx = pop(pool.empty, pool.slots); idx != 0; idx = pop(pool.empty, pool.slots)) {
+            pool.slots[idx - 1].block = m_heap->allocateSizeClass(i);
+            if (pool.slots[idx - 1].block == nullptr) {
+                push(pool.empty, pool.slots, idx);
+                break;
+            }
+
+            pool.count.fetch_add(1, std::memory_order_relaxed);
+            push(pool.ready, pool.slots, idx);
+        }
+    }
+}
+
+std::size_t SignalSafePool::availableCount(std::size_t size) const
+{
+    auto sizeClass = allocator::sizeClass(size);
+    if (size == 0 || sizeClass >= m_poolsCount)
+        return 0;
+
+    return m_pools[sizeClass].count.load(std::memory_order_relaxed);
+}
+
+void SignalSafePool::push(std::atomic<std::uint32_t>& head, Slot* slots, std::uint32_t idx)
+{
+    auto old = head.load(std::memory_order_relaxed);
+    std::uint32_t desired{};
+    do {
+        slots[idx - 1].next.store(old & m_cIndexMask, std::memory_order_relaxed);
+        desired = ((old & ~m_cIndexMask) + m_cTagStep) | idx;
+    } while (!head.compare_exchange_weak(old, desired, std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::uint32_t SignalSafePool::pop(std::atomic<std::uint32_t>& head, Slot* slots)
+{
+    auto old = head.load(std::memory_order_acquire);
+    std::uint32_t desired{};
+    do {
+        auto idx = old & m_cIndexMask;
+        if (idx == 0)
+            return 0;
+
+        auto next = slots[idx - 1].next.load(std::memory_order_relaxed);
+        desired = ((old & ~m_cIndexMask) + m_cTagStep) | next;
+    } while (!head.compare_exchange_weak(old, desired, std::memory_order_acquire, std::memory_order_acquire));
+
+    return old & m_cIndexMask;
+}
+
+SignalSafePool::Pool* SignalSafePool::findPool(std::size_t size)
+{
+    auto sizeClass = allocator::sizeClass(size);
+    if (size == 0 || sizeClass >= m_poolsCount)
+        return nullptr;
+
+    return &m_pools[sizeClass];
+}
+
+} // namespace memory
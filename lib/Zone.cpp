@@ -41,20 +41,22 @@ namespace memory {
 
 static_assert(Zone::isNaturallyAligned(), "class Zone is not naturally aligned");
 
-void Zone::init(Page* page, std::size_t pageSize, std::size_t chunkSize)
+void Zone::init(Page* page, std::size_t pageSize, std::size_t chunkSize, std::size_t offset)
 {
     assert(page);
     assert(pageSize);
     assert(chunkSize);
+    assert(offset < pageSize);
 
     clear();
 
     m_page = page;
     m_chunkSize = chunkSize;
-    m_chunksCount = pageSize / chunkSize;
+    m_offset = offset;
+    m_chunksCount = (pageSize - offset) / chunkSize;
     m_freeChunksCount = m_chunksCount;
 
-    auto* chunk = reinterpret_cast<Chunk*>(page->address());
+    auto* chunk = reinterpret_cast<Chunk*>(page->address() + offset);
     for (std::size_t i = 0; i < m_chunksCount; ++i, chunk = utils::movePtr(chunk, m_chunkSize)) {
         chunk->initListNode();
         chunk->addToList(&m_freeChunks);
@@ -66,6 +68,7 @@ void Zone::clear()
     initListNode();
     m_page = nullptr;
     m_chunkSize = 0;
+    m_offset = 0;
     m_chunksCount = 0;
     m_freeChunksCount = 0;
     m_freeChunks = nullptr;
@@ -81,25 +84,28 @@ std::size_t Zone::chunkSize() const
     return m_chunkSize;
 }
 
-std::size_t Zone::chunksCount() const
+std::size_t Zone::offset() const
 {
-    return m_chunksCount;
+    return m_offset;
 }
 
-std::size_t Zone::freeChunksCount() const
+std::size_t Zone::chunksCount() const
 {
-    return m_freeChunksCount;
+    return m_chunksCount;
 }
 
-Chunk* Zone::takeChunk()
+void Zone::takeChunks(void** chunks, std::size_t count)
 {
-    assert(m_freeChunksCount);
+    assert(chunks);
+    assert(count <= m_freeChunksCount);
 
-    auto* chunk = m_freeChunks;
-    chunk->removeFromList(&m_freeChunks);
-    --m_freeChunksCount;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto* chunk = m_freeChunks;
+        chunk->removeFromList(&m_freeChunks);
+        chunks[i] = chunk;
+    }
 
-    return chunk;
+    m_freeChunksCount -= count;
 }
 
 void Zone::giveChunk(Chunk* chunk)
@@ -112,7 +118,7 @@ void Zone::giveChunk(Chunk* chunk)
 
 bool Zone::isValidChunk(Chunk* chunk)
 {
-    auto* it = reinterpret_cast<Chunk*>(m_page->address());
+    auto* it = reinterpret_cast<Chunk*>(m_page->address() + m_offset);
     for (std::size_t i = 0; i < m_chunksCount; ++i, it = utils::movePtr(it, m_chunkSize)) {
         if (it == chunk)
             return true;
@@ -34,6 +34,7 @@
 
 #include "ListNode.hpp"
 
+#include <cassert>
 #include <cstddef>
 
 namespace memory {
@@ -75,7 +76,9 @@ public:
     /// @param page         Page to be associated with this zone.
     /// @param pageSize     Size of the associated page.
     /// @param chunkSize    Size of the chunk to be used within this zone.
-    void init(Page* page, std::size_t pageSize, std::size_t chunkSize);
+    /// @param offset       Offset of the first chunk from the beginning of the page. It must preserve the alignment
+    ///                     of the chunks.
+    void init(Page* page, std::size_t pageSize, std::size_t chunkSize, std::size_t offset = 0);
 
     /// Clears the internal state of the zone.
     void clear();
@@ -88,18 +91,37 @@ public:
     /// @return Size of the chunks created from this zone.
     [[nodiscard]] std::size_t chunkSize() const;
 
+    /// Returns offset of the first chunk from the beginning of the page.
+    /// @return Offset of the first chunk in this zone.
+    [[nodiscard]] std::size_t offset() const;
+
     /// Returns total count of the chunks, that are part of this zone.
     /// @return Number of chunks, that create this zone.
     [[nodiscard]] std::size_t chunksCount() const;
 
     /// Returns number of the non-allocated chunks in this zone.
     /// @return Number of chunks, that are not allocated in this zone.
-    [[nodiscard]] std::size_t freeChunksCount() const;
+    [[nodiscard]] std::size_t freeChunksCount() const { return m_freeChunksCount; }
 
     /// Allocates the chunk from this zone and returns it.
     /// @return Allocated chunk.
     /// @note This function updates the 'free' counter.
-    Chunk* takeChunk();
+    Chunk* takeChunk()
+    {
+        assert(m_freeChunksCount);
+
+        auto* chunk = m_freeChunks;
+        chunk->removeFromList(&m_freeChunks);
+        --m_freeChunksCount;
+
+        return chunk;
+    }
+
+    /// Allocates the given number of chunks from this zone at once.
+    /// @param chunks       Array, to which allocated chunks should be stored.
+    /// @param count        Number of chunks to be allocated. It must not exceed the number of free chunks.
+    /// @note This function updates the 'free' counter only once.
+    void takeChunks(void** chunks, std::size_t count);
 
     /// Releases the given chunk.
     /// @param chunk        Chunk to be released.
@@ -122,7 +144,8 @@ public:
     {
         constexpr std::size_t cRequiredSize = sizeof(ListNode<Zone>) // Inherited fields
                                             + sizeof(m_page)         // NOLINT(bugprone-sizeof-expression)
-                                            + sizeof(m_chunkSize) + sizeof(m_chunksCount) + sizeof(m_freeChunksCount)
+                                            + sizeof(m_chunkSize) + sizeof(m_offset) + sizeof(m_chunksCount)
+                                            + sizeof(m_freeChunksCount)
                                             + sizeof(m_freeChunks); // NOLINT(bugprone-sizeof-expression)
         return (cRequiredSize == sizeof(Zone));
     }
@@ -130,6 +153,7 @@ public:
 private:
     Page* m_page{};                  ///< Page, that is associated with this zone.
     std::size_t m_chunkSize{};       ///< Size of the chunks, that are part of this zone.
+    std::size_t m_offset{};          ///< Offset of the first chunk from the beginning of the page.
     std::size_t m_chunksCount{};     ///< Number of chunks in this zone.
     std::size_t m_freeChunksCount{}; ///< Number of free chunks in this zone.
     Chunk* m_freeChunks{};           ///< List of free chunks in this zone.
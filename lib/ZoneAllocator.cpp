@@ -32,14 +32,44 @@
 
 #include "ZoneAllocator.hpp"
 
+#include "Cache.hpp"
 #include "Page.hpp"
 #include "PageAllocator.hpp"
 
+#include <allocator/allocator.hpp>
+
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <numeric>
 
 namespace memory {
+namespace {
+
+/// Checks if the lookup table and the integer math give the same zone indexes as the rounding of the chunk size.
+/// @return Flag indicating if all zone indexes are consistent.
+consteval bool isSizeIdxValid()
+{
+    constexpr std::size_t cMaxSize = 4 * detail::cSmallSizeMax;
+    for (std::size_t size = 1; size <= cMaxSize; ++size) {
+        auto idx = detail::sizeIdx(size);
+        if (idx != detail::zoneIdx(detail::chunkSize(size)) || idx != allocator::sizeClass(size))
+            return false;
+
+        if (detail::zoneChunkSize(idx) < size || (idx > 0 && detail::zoneChunkSize(idx - 1) >= size))
+            return false;
+    }
+
+    return true;
+}
+
+static_assert(isSizeIdxValid(), "zone index lookup is not consistent");
+static_assert(detail::sizeIdx(0) == 0 && detail::sizeIdx(1) == 0, "invalid zone index of the smallest sizes");
+static_assert(detail::zoneIdx(ZoneAllocator::minimalAllocSize()) == 0, "invalid zone index of the minimal chunk");
+static_assert(config::cSizeClassesCount <= 16, "zone index does not fit into the page flags"); // NOLINT
+
+} // namespace
 
 ZoneAllocator::ZoneAllocator() noexcept
 {
@@ -69,29 +99,106 @@ void ZoneAllocator::clear()
     m_zoneDescIdx = 0;
     m_initialZone.clear();
     m_zones.fill({});
+    m_caches = nullptr;
 }
 
-void* ZoneAllocator::allocate(std::size_t size)
+void* ZoneAllocator::allocateSlow(std::size_t size)
 {
     if (size == 0)
         return nullptr;
 
-    std::size_t allocSize = detail::chunkSize(size);
+    if (isPageAllocation(size))
+        return allocatePages(size, false);
 
-    if (size >= m_pageSize || allocSize >= m_pageSize) {
-        auto pageCount = static_cast<std::size_t>(std::ceil(double(size) / double(m_pageSize)));
-        if (auto* page = m_pageAllocator->allocate(pageCount))
-            return reinterpret_cast<void*>(page->address());
+    return allocateSizeClassSlow(detail::sizeIdx(size));
+}
 
-        return nullptr;
-    }
+void* ZoneAllocator::allocateSizeClassSlow(std::size_t idx)
+{
+    std::size_t allocSize = detail::zoneChunkSize(idx);
+    if (allocSize > maxChunkSize())
+        return allocatePages(allocSize, false);
 
-    std::size_t idx = detail::zoneIdx(allocSize);
     Zone* zone = shouldAllocateZone(idx) ? allocateZone(allocSize) : getFreeZone(idx);
     if (zone == nullptr)
         return nullptr;
 
-    return allocateChunk<void>(zone);
+    m_zones.at(idx).current = zone;
+    return allocateChunk<void>(zone, idx);
+}
+
+void* ZoneAllocator::allocateZeroed(std::size_t size)
+{
+    if (size == 0)
+        return nullptr;
+
+    if (isPageAllocation(size))
+        return allocatePages(size, true);
+
+    auto* ptr = allocate(size);
+    if (ptr != nullptr)
+        std::memset(ptr, 0, size);
+
+    return ptr;
+}
+
+void* ZoneAllocator::allocateAligned(std::size_t size, std::size_t alignment)
+{
+    assert(utils::isPowerOf2(alignment));
+
+    // Chunks are aligned to their size and pages are aligned to the page size, so it is enough to ask for more memory.
+    if (alignment <= pageSize())
+        return allocate(std::max(size, alignment));
+
+    auto pageCount = utils::divRoundUp(std::max<std::size_t>(size, 1), pageSize());
+    auto* page = m_pageAllocator->allocateAligned(pageCount, alignment);
+    if (page == nullptr)
+        return nullptr;
+
+    // Page could have been used by a zone before the PageAllocator has been reset.
+    page->setZone(false);
+    page->setCache(false);
+    return reinterpret_cast<void*>(page->address());
+}
+
+bool ZoneAllocator::allocateBatch(std::size_t size, void** ptrs, std::size_t count)
+{
+    assert(ptrs || count == 0);
+
+    if (size == 0)
+        return false;
+
+    if (isPageAllocation(size)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if ((ptrs[i] = allocate(size)) == nullptr) {
+                releaseBatch(ptrs, i);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::size_t idx = detail::sizeIdx(size);
+    std::size_t allocSize = detail::zoneChunkSize(idx);
+    std::size_t triggerCount = (idx == m_zoneDescIdx) ? 1 : 0;
+
+    for (std::size_t i = 0; i < count;) {
+        Zone* zone = shouldAllocateZone(idx) ? allocateZone(allocSize) : getFreeZone(idx);
+        if (zone == nullptr) {
+            releaseBatch(ptrs, i);
+            return false;
+        }
+
+        auto& zoneInfo = m_zones.at(idx);
+        zoneInfo.current = zone;
+        auto takenCount = std::min({zone->freeChunksCount(), count - i, zoneInfo.freeChunksCount - triggerCount});
+        zone->takeChunks(ptrs + i, takenCount);
+        zoneInfo.freeChunksCount -= takenCount;
+        i += takenCount;
+    }
+
+    return true;
 }
 
 void ZoneAllocator::release(void* ptr)
@@ -99,11 +206,163 @@ void ZoneAllocator::release(void* ptr)
     if (ptr == nullptr)
         return;
 
-    if (deallocateChunk(ptr))
+    auto* page = m_pageAllocator->getPage(std::uintptr_t(ptr));
+    if (page == nullptr)
+        return;
+
+    if (!page->isZone()) {
+        m_pageAllocator->release(page);
+        return;
+    }
+
+    if (page->isCache()) {
+        static_cast<Cache*>(page->owner())->release(ptr);
+        return;
+    }
+
+    auto* chunk = reinterpret_cast<Chunk*>(ptr);
+    auto* zone = static_cast<Zone*>(page->owner());
+    if (zone != nullptr && isZoneChunk(zone, chunk))
+        giveChunk(zone, chunk);
+}
+
+void ZoneAllocator::releaseBatch(void** ptrs, std::size_t count)
+{
+    assert(ptrs || count == 0);
+
+    Zone* zone = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto* chunk = reinterpret_cast<Chunk*>(ptrs[i]);
+        if (chunk == nullptr)
+            continue;
+
+        if (zone == nullptr || !isZoneChunk(zone, chunk))
+            zone = findZone(chunk);
+
+        if (zone == nullptr) {
+            release(chunk);
+            continue;
+        }
+
+        // Zone is released together with its last chunk, so it cannot be used for the next chunk.
+        bool lastChunk = (zone->freeChunksCount() + 1 == zone->chunksCount());
+        giveChunk(zone, chunk);
+        if (lastChunk)
+            zone = nullptr;
+    }
+}
+
+void ZoneAllocator::release(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    assert(size);
+
+    if (isPageAllocation(size)) {
+        // Given size has to match the one used in allocate(), otherwise page of some zone could be released here.
+        assert(findZone(reinterpret_cast<Chunk*>(ptr)) == nullptr);
+
+        if (auto* pages = m_pageAllocator->getPage(std::uintptr_t(ptr))) {
+            assert(pages->groupSize() == utils::divRoundUp(size, pageSize()));
+            m_pageAllocator->release(pages);
+        }
+
+        return;
+    }
+
+    releaseSizeClass(ptr, detail::sizeIdx(size));
+}
+
+void ZoneAllocator::releaseSizeClass(void* ptr, std::size_t idx)
+{
+    if (ptr == nullptr)
+        return;
+
+    std::size_t allocSize = detail::zoneChunkSize(idx);
+    if (allocSize > maxChunkSize()) {
+        release(ptr, allocSize);
         return;
+    }
+
+    auto* chunk = reinterpret_cast<Chunk*>(ptr);
+    auto* zone = findZone(chunk);
+    assert(zone && detail::zoneIdx(zone->chunkSize()) == idx);
+    if (zone)
+        giveChunk(zone, chunk);
+}
+
+void* ZoneAllocator::reallocate(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr)
+        return allocate(size);
+
+    if (size == 0) {
+        release(ptr);
+        return nullptr;
+    }
+
+    std::size_t oldSize = 0;
+    if (auto* zone = findZone(reinterpret_cast<Chunk*>(ptr))) {
+        oldSize = zone->chunkSize();
+        if (!isPageAllocation(size) && detail::chunkSize(size) == oldSize)
+            return ptr;
+    }
+    else if (auto* pages = m_pageAllocator->getPage(std::uintptr_t(ptr)); pages != nullptr && pages->isCache()) {
+        oldSize = static_cast<Cache*>(pages->owner())->objectSize();
+    }
+    else if (pages != nullptr) {
+        oldSize = pages->groupSize() * pageSize();
+        auto pageCount = utils::divRoundUp(size, pageSize());
+        if (isPageAllocation(size)) {
+            if (m_pageAllocator->resize(pages, pageCount))
+                return ptr;
+
+            // Big blocks from dedicated regions are moved by the page provider instead of being copied.
+            if (auto* movedPages = m_pageAllocator->remap(pages, pageCount))
+                return reinterpret_cast<void*>(movedPages->address());
+        }
+    }
+    else {
+        return nullptr;
+    }
 
-    if (auto* pages = m_pageAllocator->getPage(std::uintptr_t(ptr)))
-        m_pageAllocator->release(pages);
+    auto* newPtr = allocate(size);
+    if (newPtr == nullptr)
+        return nullptr;
+
+    std::memcpy(newPtr, ptr, std::min(oldSize, size));
+    release(ptr);
+    return newPtr;
+}
+
+std::size_t ZoneAllocator::usableSize(void* ptr)
+{
+    if (ptr == nullptr)
+        return 0;
+
+    auto* page = m_pageAllocator->getPage(std::uintptr_t(ptr));
+    if (page == nullptr)
+        return 0;
+
+    if (page->isCache())
+        return static_cast<Cache*>(page->owner())->objectSize();
+
+    if (page->isZone())
+        return detail::zoneChunkSize(page->zoneIdx());
+
+    return page->groupSize() * pageSize();
+}
+
+std::size_t ZoneAllocator::allocationSize(std::size_t size) const
+{
+    if (size == 0)
+        return 0;
+
+    if (isPageAllocation(size))
+        return utils::roundUp(size, pageSize());
+
+    return detail::chunkSize(size);
 }
 
 ZoneAllocator::Stats ZoneAllocator::getStats()
@@ -118,9 +377,9 @@ ZoneAllocator::Stats ZoneAllocator::getStats()
     });
 
     Stats stats{};
-    stats.usedMemorySize = usedZonesCount * m_pageSize;
+    stats.usedMemorySize = usedZonesCount * pageSize();
     stats.reservedMemorySize = (usedZonesCount > 0) ? (usedZonesCount - 1) * m_zoneDescChunkSize : 0;
-    stats.freeMemorySize = std::accumulate(start, end, 0U, [](const size_t& sum, const ZoneInfo& zoneInfo) {
+    stats.freeMemorySize = std::accumulate(start, end, std::size_t{0}, [](const size_t& sum, const ZoneInfo& zoneInfo) {
         if (zoneInfo.head == nullptr)
             return sum;
 
@@ -131,6 +390,70 @@ ZoneAllocator::Stats ZoneAllocator::getStats()
     return stats;
 }
 
+void ZoneAllocator::addCache(Cache* cache)
+{
+    assert(cache);
+    cache->addToList(&m_caches);
+}
+
+void ZoneAllocator::removeCache(Cache* cache)
+{
+    assert(cache);
+    cache->removeFromList(&m_caches);
+}
+
+std::size_t ZoneAllocator::shrinkCaches()
+{
+    std::size_t zonesCount = 0;
+    for (auto* cache = m_caches; cache != nullptr; cache = cache->next())
+        zonesCount += cache->shrink();
+
+    return zonesCount * pageSize();
+}
+
+bool ZoneAllocator::isPageAllocation(std::size_t size) const
+{
+    return (size > maxChunkSize());
+}
+
+void* ZoneAllocator::allocatePages(std::size_t size, bool zeroed)
+{
+    // Size rounded up to the whole pages has to be representable, or the pages would be allocated for nothing.
+    if (size > std::numeric_limits<std::size_t>::max() - pageSize())
+        return nullptr;
+
+    auto pageCount = utils::divRoundUp(size, pageSize());
+    auto* page = zeroed ? m_pageAllocator->allocateZeroed(pageCount) : m_pageAllocator->allocate(pageCount);
+    if (page == nullptr)
+        return nullptr;
+
+    // Page could have been used by a zone before the PageAllocator has been reset.
+    page->setZone(false);
+    page->setCache(false);
+    return reinterpret_cast<void*>(page->address());
+}
+
+void ZoneAllocator::giveChunk(Zone* zone, Chunk* chunk) // NOLINT(misc-no-recursion)
+{
+    assert(zone);
+    assert(chunk);
+
+    std::size_t idx = detail::zoneIdx(zone->chunkSize());
+    m_zones.at(idx).freeChunksCount++;
+    chunk->initListNode();
+    zone->giveChunk(chunk);
+
+    if (zone->chunksCount() == zone->freeChunksCount() && zone != &m_initialZone) {
+        removeZone(zone);
+        clearZone(zone);
+
+        auto* zoneChunk = reinterpret_cast<Chunk*>(zone);
+        auto* descZone = findZone(zoneChunk);
+        assert(descZone);
+        giveChunk(descZone, zoneChunk);
+    }
+}
+
 Zone* ZoneAllocator::getFreeZone(std::size_t idx)
 {
     Zone* zone = nullptr;
@@ -157,7 +480,7 @@ Zone* ZoneAllocator::allocateZone(std::size_t chunkSize) // NOLINT(misc-no-recur
 
     auto* zone = getFreeZone(m_zoneDescIdx);
     assert(zone);
-    auto* newZone = allocateChunk<Zone>(zone);
+    auto* newZone = allocateChunk<Zone>(zone, m_zoneDescIdx);
     assert(newZone);
 
     if (!initZone(newZone, chunkSize)) {
@@ -174,7 +497,11 @@ bool ZoneAllocator::initZone(Zone* zone, std::size_t chunkSize)
     assert(zone);
 
     if (auto* page = m_pageAllocator->allocate(1)) {
-        zone->init(page, m_pageSize, chunkSize);
+        zone->init(page, pageSize(), chunkSize);
+        page->setZone(true);
+        page->setCache(false);
+        page->setZoneIdx(detail::zoneIdx(chunkSize));
+        page->setOwner(zone);
         return true;
     }
 
@@ -185,6 +512,8 @@ void ZoneAllocator::clearZone(Zone* zone)
 {
     assert(zone);
 
+    zone->page()->setZone(false);
+    zone->page()->setOwner(nullptr);
     m_pageAllocator->release(zone->page());
     zone->clear();
 }
@@ -206,23 +535,37 @@ void ZoneAllocator::removeZone(Zone* zone)
     auto idx = detail::zoneIdx(zone->chunkSize());
     zone->removeFromList(&m_zones.at(idx).head);
     m_zones.at(idx).freeChunksCount -= zone->freeChunksCount();
+    if (m_zones.at(idx).current == zone)
+        m_zones.at(idx).current = nullptr;
 }
 
-Zone* ZoneAllocator::findZone(Chunk* chunk)
+bool ZoneAllocator::isZoneChunk(Zone* zone, Chunk* chunk) const
 {
+    assert(zone);
     assert(chunk);
 
     auto chunkAddr = reinterpret_cast<std::uintptr_t>(chunk);
-    auto pageAddr = chunkAddr & ~(m_pageSize - 1);
+    auto firstChunkAddr = zone->page()->address() + zone->offset();
+    if (chunkAddr < firstChunkAddr || (chunkAddr - firstChunkAddr) % zone->chunkSize() != 0)
+        return false;
 
-    for (auto& zoneInfo : m_zones) {
-        for (auto* zone = zoneInfo.head; zone != nullptr; zone = zone->next()) {
-            if (zone->page()->address() == pageAddr && zone->isValidChunk(chunk))
-                return zone;
-        }
-    }
+    return ((chunkAddr - firstChunkAddr) / zone->chunkSize() < zone->chunksCount());
+}
+
+Zone* ZoneAllocator::findZone(Chunk* chunk)
+{
+    assert(chunk);
 
-    return nullptr;
+    // Page descriptor points directly to its zone, so no zone list has to be searched.
+    auto* page = m_pageAllocator->getPage(reinterpret_cast<std::uintptr_t>(chunk));
+    if (page == nullptr || !page->isZone() || page->isCache())
+        return nullptr;
+
+    auto* zone = static_cast<Zone*>(page->owner());
+    if (zone == nullptr || !isZoneChunk(zone, chunk))
+        return nullptr;
+
+    return zone;
 }
 
 } // namespace memory
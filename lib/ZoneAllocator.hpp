@@ -35,18 +35,22 @@
 #include "Zone.hpp"
 #include "utils.hpp"
 
+#include <allocator/config.hpp>
+
 #include <algorithm>
 #include <array>
-#include <cmath>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 namespace memory {
 
+class Cache;
 class PageAllocator;
 
 namespace detail {
 
-std::size_t zoneIdx(std::size_t chunkSize);
+constexpr std::size_t zoneIdx(std::size_t chunkSize);
 
 } // namespace detail
 
@@ -80,34 +84,178 @@ public:
     /// @return Result of the allocation.
     /// @retval void*               Pointer to the allocated memory chunk on success.
     /// @retval nullptr             Some error occurred.
+    /// @note Chunk is taken directly from the current zone of the size class whenever possible. This fast path is
+    ///       inlined, while creation of the zones and allocation of the pages is done out of line.
     [[nodiscard]] void* allocate(std::size_t size);
 
+    /// Allocates the memory chunk from the zones with the given index.
+    /// @param idx                  Index of the zones, from which chunk should be allocated.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Index is equal to allocator::sizeClass() of the demanded size, so it can be computed at compile time.
+    ///       Chunks not smaller than the page are allocated directly from the PageAllocator.
+    [[nodiscard]] void* allocateSizeClass(std::size_t idx);
+
+    /// Allocates the memory chunk of at least given size and fills it with zeros.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Pages, that are known to contain zeros, are not cleared again.
+    [[nodiscard]] void* allocateZeroed(std::size_t size);
+
+    /// Allocates the memory chunk of at least given size with the given alignment.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @param alignment            Demanded alignment of the memory chunk. It must be a power of 2.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note Alignments bigger than the page size are always served directly from the PageAllocator.
+    [[nodiscard]] void* allocateAligned(std::size_t size, std::size_t alignment);
+
+    /// Allocates the given number of memory chunks of at least given size.
+    /// @param size                 Size of each demanded memory chunk.
+    /// @param ptrs                 Array, to which pointers to the allocated memory chunks should be stored.
+    /// @param count                Number of memory chunks to be allocated.
+    /// @return Result of the allocation.
+    /// @retval true                All memory chunks have been allocated.
+    /// @retval false               Some error occurred. No memory chunk is allocated in that case.
+    /// @note Size class and zone are selected once for all chunks, that fit into the same zone.
+    [[nodiscard]] bool allocateBatch(std::size_t size, void** ptrs, std::size_t count);
+
     /// Releases the given memory chunk.
     /// @param ptr                  Pointer to the memory chunk to be released.
     /// @note This function accepts nullptr input.
     void release(void* ptr);
 
+    /// Releases the given number of memory chunks.
+    /// @param ptrs                 Array of pointers to the memory chunks to be released.
+    /// @param count                Number of memory chunks to be released.
+    /// @note This function accepts nullptr entries in the array.
+    /// @note Owner zone is looked up only once for each run of consecutive chunks from the same zone.
+    void releaseBatch(void** ptrs, std::size_t count);
+
+    /// Releases the given memory chunk, that was allocated with the given size.
+    /// @param ptr                  Pointer to the memory chunk to be released.
+    /// @param size                 Size, that was used to allocate the given memory chunk.
+    /// @note This function accepts nullptr input.
+    /// @note Knowing the size allows to skip the search of the owner among zones of the other chunk sizes.
+    /// @note Passing size different from the one used in allocate() is checked with assertions in debug builds.
+    void release(void* ptr, std::size_t size);
+
+    /// Releases the given memory chunk, that was allocated from the zones with the given index.
+    /// @param ptr                  Pointer to the memory chunk to be released.
+    /// @param idx                  Index, that was used to allocate the given memory chunk.
+    /// @note This function accepts nullptr input.
+    void releaseSizeClass(void* ptr, std::size_t idx);
+
+    /// Changes the size of the given memory chunk.
+    /// @param ptr                  Pointer to the memory chunk to be resized.
+    /// @param size                 Demanded size of the memory chunk.
+    /// @return Result of the reallocation.
+    /// @retval void*               Pointer to the resized memory chunk on success.
+    /// @retval nullptr             Some error occurred. The given memory chunk is left untouched.
+    /// @note If ptr is nullptr, then this function is equivalent to allocate(size).
+    /// @note If size is 0, then this function is equivalent to release(ptr) and returns nullptr.
+    /// @note Chunk stays in place if the new size has the same chunk size. Set of pages grows in place if the pages
+    ///       directly after it are free and shrinks in place by releasing its tail.
+    [[nodiscard]] void* reallocate(void* ptr, std::size_t size);
+
+    /// Returns the real size of the given memory chunk.
+    /// @param ptr                  Pointer to the memory chunk returned by one of the allocation functions.
+    /// @return Size of the memory chunk, that can be used by the user.
+    /// @note This function works in constant time. It returns 0 for nullptr or for unknown pointers.
+    std::size_t usableSize(void* ptr);
+
+    /// Returns the real size of the memory chunk, that would be allocated for the given size.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @return Size of the memory chunk, that would be allocated.
+    [[nodiscard]] std::size_t allocationSize(std::size_t size) const;
+
     /// Returns the current statistics of ZoneAllocator.
     /// @return ZoneAllocator statistics.
     Stats getStats();
 
+    /// Registers the given object cache, whose descriptor has been allocated from this ZoneAllocator.
+    /// @param cache                Object cache to be registered.
+    void addCache(Cache* cache);
+
+    /// Unregisters the given object cache.
+    /// @param cache                Object cache to be unregistered.
+    void removeCache(Cache* cache);
+
+    /// Gives the empty zones retained by all registered object caches back to the PageAllocator.
+    /// @return Size of the memory, that has been given back.
+    std::size_t shrinkCaches();
+
     /// Returns minimal size of chunk, that can be allocated.
     /// @return Minimal size of chunk, that can be allocated.
     static constexpr std::size_t minimalAllocSize()
     {
-        constexpr std::size_t cMinimalAllocSize = 16;
-        return cMinimalAllocSize;
+        return config::cMinimalAllocSize;
     }
 
 private:
+    /// Allocates the memory chunk of at least given size, when the fast path in allocate() has failed.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    [[gnu::cold]] void* allocateSlow(std::size_t size);
+
+    /// Allocates the memory chunk from the zones with the given index, when the fast path has failed.
+    /// @param idx                  Index of the zones, from which chunk should be allocated.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the allocated memory chunk on success.
+    /// @retval nullptr             Some error occurred.
+    /// @note This function selects the zone, that is used by the fast path for the next allocations.
+    [[gnu::cold]] void* allocateSizeClassSlow(std::size_t idx);
+
+    /// Takes the chunk from the current zone with the given index.
+    /// @param idx                  Index of the zones, from which chunk should be taken.
+    /// @return Result of the operation.
+    /// @retval void*               Pointer to the taken memory chunk on success.
+    /// @retval nullptr             Current zone is not set or is full, or a new zone would have to be allocated.
+    void* takeCurrentChunk(std::size_t idx);
+
+    /// Returns size of the page.
+    /// @return Size of the page.
+    /// @note If the page size is fixed at compile time, then all calculations based on it are folded by the compiler.
+    [[nodiscard]] std::size_t pageSize() const { return config::pageSize(m_pageSize); }
+
+    /// Returns size of the biggest chunk, that is allocated from the zones.
+    /// @return Size of the biggest chunk served by the zones.
+    /// @note Chunk has to be smaller than the page and its size class has to fit into the zone array.
+    [[nodiscard]] std::size_t maxChunkSize() const
+    {
+        return std::min(pageSize() / 2, minimalAllocSize() << (m_cMaxZoneIdx - 1));
+    }
+
+    /// Checks if memory chunk of the given size is allocated directly from the PageAllocator.
+    /// @param size                 Size of the memory chunk.
+    /// @return Flag indicating if memory chunk of the given size is allocated directly from the PageAllocator.
+    /// @retval true                Memory chunk is allocated from the PageAllocator.
+    /// @retval false               Memory chunk is allocated from one of the zones.
+    [[nodiscard]] bool isPageAllocation(std::size_t size) const;
+
+    /// Allocates the continuous set of pages, that can hold the given size.
+    /// @param size                 Size of the demanded memory chunk.
+    /// @param zeroed               Flag indicating if the allocated pages should be filled with zeros.
+    /// @return Result of the allocation.
+    /// @retval void*               Pointer to the first allocated page on success.
+    /// @retval nullptr             Some error occurred.
+    void* allocatePages(std::size_t size, bool zeroed);
+
     /// Allocates memory chunk from the given zone.
     /// @param zone                 Zone from which chunk should be allocated.
+    /// @param idx                  Index of the given zone.
     /// @return Allocated memory chunk.
     /// @note Template parameter is used here to cast the returned value the given type.
     template <typename T>
-    T* allocateChunk(Zone* zone)
+    T* allocateChunk(Zone* zone, std::size_t idx)
     {
-        std::size_t idx = detail::zoneIdx(zone->chunkSize());
+        assert(idx == detail::zoneIdx(zone->chunkSize()));
         m_zones.at(idx).freeChunksCount--;
         return reinterpret_cast<T*>(zone->takeChunk());
     }
@@ -119,27 +267,22 @@ private:
     /// @retval false               Chunk has not been deallocated.
     /// @note Template parameter is used here to accept any input without casting.
     template <typename T>
-    bool deallocateChunk(T* chunk) // NOLINT(misc-no-recursion)
+    bool deallocateChunk(T* chunk)
     {
         auto* zoneChunk = reinterpret_cast<Chunk*>(chunk);
         auto* zone = findZone(zoneChunk);
         if (!zone)
             return false;
 
-        std::size_t idx = detail::zoneIdx(zone->chunkSize());
-        m_zones.at(idx).freeChunksCount++;
-        zoneChunk->initListNode();
-        zone->giveChunk(zoneChunk);
-
-        if (zone->chunksCount() == zone->freeChunksCount() && zone != &m_initialZone) {
-            removeZone(zone);
-            clearZone(zone);
-            return deallocateChunk(zone);
-        }
-
+        giveChunk(zone, zoneChunk);
         return true;
     }
 
+    /// Returns the given chunk to the given zone and releases the zone if it becomes completely free.
+    /// @param zone                 Zone, that given chunk belongs to.
+    /// @param chunk                Chunk to be returned.
+    void giveChunk(Zone* zone, Chunk* chunk);
+
     /// Returns the Zone from the given array index, that has at least one free chunk.
     /// @param idx                  Index from which Zone should be taken.
     /// @return Result of the search.
@@ -181,20 +324,30 @@ private:
     /// @param zone                 Zone to be removed.
     void removeZone(Zone* zone);
 
+    /// Checks if the given chunk belongs to the given zone.
+    /// @param zone                 Zone to be checked.
+    /// @param chunk                Chunk to be checked.
+    /// @return Flag indicating if the given chunk belongs to the given zone.
+    /// @retval true                Chunk belongs to the zone.
+    /// @retval false               Chunk does not belong to the zone.
+    bool isZoneChunk(Zone* zone, Chunk* chunk) const;
+
     /// Finds the Zone that given chunk belong to.
     /// @param chunk                Chunk for which zone should be found.
     /// @return Result of the search.
     /// @retval Zone*               Zone that given chunk belong to if found.
     /// @retval nullptr             Zone has not been found.
+    /// @note This function works in constant time.
     Zone* findZone(Chunk* chunk);
 
 private:
-    static constexpr std::size_t m_cMaxZoneIdx = 8; ///< Maximal supported entries in the zone array.
+    static constexpr std::size_t m_cMaxZoneIdx = config::cSizeClassesCount; ///< Number of entries in the zone array.
 
 private:
     /// Represents the meta-data of the zone.
     struct ZoneInfo {
         Zone* head{};                  ///< Head of the zones with the given index.
+        Zone* current{};               ///< Zone, from which chunks are taken by the fast path.
         std::size_t freeChunksCount{}; ///< Total number of free chunks in zones with the given index.
     };
 
@@ -204,6 +357,7 @@ private:
     std::size_t m_zoneDescIdx{};                   ///< Index of the zones, from which zone descriptors are allocated.
     Zone m_initialZone{};                          ///< Initial static zone.
     std::array<ZoneInfo, m_cMaxZoneIdx> m_zones{}; ///< Array of all zones known in the ZoneAllocator.
+    Cache* m_caches{};                             ///< List of the registered object caches.
 };
 
 namespace detail {
@@ -211,19 +365,88 @@ namespace detail {
 /// Returns size rounded up to the closest chunk size.
 /// @param size                     Size to be rounded up.
 /// @return Closest chunk size.
-inline std::size_t chunkSize(std::size_t size)
+constexpr std::size_t chunkSize(std::size_t size)
 {
     std::size_t chunkSize = std::max(size, ZoneAllocator::minimalAllocSize());
     return utils::roundPowerOf2(chunkSize);
 }
 
+/// Returns size of the chunks in the zone with the given index.
+/// @param idx                      Index of the zone.
+/// @return Size of the chunks in the zone.
+constexpr std::size_t zoneChunkSize(std::size_t idx)
+{
+    return ZoneAllocator::minimalAllocSize() << idx;
+}
+
 /// Returns an index of the zone with the given chunk size.
 /// @param chunkSize                Chunk size to be used in calculations.
 /// @return Index of the zone in the array of all known zones.
-inline std::size_t zoneIdx(std::size_t chunkSize)
+constexpr std::size_t zoneIdx(std::size_t chunkSize)
 {
-    return static_cast<std::size_t>(std::floor(std::log2(chunkSize)) - 4);
+    return utils::log2(chunkSize) - utils::log2(ZoneAllocator::minimalAllocSize());
+}
+
+/// Maximal size, for which zone index is taken from the lookup table.
+constexpr std::size_t cSmallSizeMax = 1024;
+
+/// Lookup table with zone indexes of the small sizes. Entry i holds the index for sizes up to i * minimalAllocSize().
+constexpr auto cSmallSizeIdx = [] {
+    constexpr std::size_t cStep = ZoneAllocator::minimalAllocSize();
+    std::array<std::uint8_t, cSmallSizeMax / cStep + 1> table{};
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table.at(i) = static_cast<std::uint8_t>(zoneIdx(chunkSize(i * cStep)));
+
+    return table;
+}();
+
+/// Returns an index of the zone, that serves allocations of the given size.
+/// @param size                     Size of the demanded memory chunk.
+/// @return Index of the zone in the array of all known zones.
+/// @note This is equivalent to zoneIdx(chunkSize(size)), but small sizes are looked up in the precomputed table.
+constexpr std::size_t sizeIdx(std::size_t size)
+{
+    constexpr std::size_t cStep = ZoneAllocator::minimalAllocSize();
+    if (size <= cSmallSizeMax)
+        return cSmallSizeIdx[(size + cStep - 1) / cStep]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+
+    return utils::log2(size - 1) + 1 - utils::log2(cStep);
 }
 
 } // namespace detail
+
+inline void* ZoneAllocator::allocate(std::size_t size)
+{
+    // Size 0 wraps around here, so it is handled by the slow path.
+    if (size - 1 < maxChunkSize()) [[likely]] {
+        if (auto* chunk = takeCurrentChunk(detail::sizeIdx(size))) [[likely]]
+            return chunk;
+    }
+
+    return allocateSlow(size);
+}
+
+inline void* ZoneAllocator::allocateSizeClass(std::size_t idx)
+{
+    if (detail::zoneChunkSize(idx) <= maxChunkSize()) [[likely]] {
+        if (auto* chunk = takeCurrentChunk(idx)) [[likely]]
+            return chunk;
+    }
+
+    return allocateSizeClassSlow(idx);
+}
+
+inline void* ZoneAllocator::takeCurrentChunk(std::size_t idx)
+{
+    auto& zoneInfo = m_zones[idx]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    auto* zone = zoneInfo.current;
+
+    // Last free chunk is left to the slow path, because zone descriptors always keep one chunk in reserve.
+    if (zone == nullptr || zone->freeChunksCount() == 0 || zoneInfo.freeChunksCount < 2)
+        return nullptr;
+
+    --zoneInfo.freeChunksCount;
+    return zone->takeChunk();
+}
+
 } // namespace memory
@@ -30,21 +30,17 @@
 ///
 /////////////////////////////////////////////////////////////////////////////////////
 
-#include "PageAllocator.hpp"
-#include "ZoneAllocator.hpp"
 #include "version.hpp"
 
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+#include <allocator/ObjectCache.hpp>
 #include <allocator/allocator.hpp>
 
-#include <array>
-
 namespace {
 
 // NOLINTNEXTLINE(fuchsia-statically-constructed-objects,cppcoreguidelines-avoid-non-const-global-variables)
-memory::PageAllocator pageAllocator;
-
-// NOLINTNEXTLINE(fuchsia-statically-constructed-objects,cppcoreguidelines-avoid-non-const-global-variables)
-memory::ZoneAllocator zoneAllocator;
+memory::Heap heap;
 
 } // namespace
 
@@ -55,58 +51,141 @@ const char* version()
     return cLiballocatorVersion;
 }
 
-bool init(Region* regions, std::size_t pageSize)
+bool init(Region* regions, std::size_t pageSize, bool zeroed)
+{
+    return heap.init(regions, pageSize, zeroed);
+}
+
+bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize, bool zeroed)
+{
+    return heap.init(start, end, pageSize, zeroed);
+}
+
+bool addRegion(const Region& region, bool zeroed)
+{
+    return heap.addRegion(region, zeroed);
+}
+
+void setPageProvider(PageProvider* provider, std::size_t directThreshold)
+{
+    heap.setPageProvider(provider, directThreshold);
+}
+
+void setDecommitThreshold(std::size_t threshold)
+{
+    heap.setDecommitThreshold(threshold);
+}
+
+std::size_t trim()
 {
-    clear();
+    return heap.trim();
+}
 
-    if (!pageAllocator.init(regions, pageSize))
-        return false;
+void setEmergencyReserve(std::size_t size)
+{
+    heap.setEmergencyReserve(size);
+}
 
-    return zoneAllocator.init(&pageAllocator, pageSize);
+void setWatermarks(std::size_t low, std::size_t high)
+{
+    heap.setWatermarks(low, high);
 }
 
-bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize)
+bool addShrinker(const Shrinker& shrinker)
 {
-    std::array<Region, 2> regions = {
-        {{start, end - start}, {0, 0}}
-    };
+    return heap.addShrinker(shrinker);
+}
 
-    return init(regions.data(), pageSize);
+void removeShrinker(const Shrinker& shrinker)
+{
+    heap.removeShrinker(shrinker);
 }
 
 void clear()
 {
-    pageAllocator.clear();
-    zoneAllocator.clear();
+    heap.clear();
 }
 
 void* allocate(std::size_t size)
 {
-    return zoneAllocator.allocate(size);
+    return heap.allocate(size);
+}
+
+AllocationResult allocateAtLeast(std::size_t size)
+{
+    return heap.allocateAtLeast(size);
+}
+
+void* allocateSizeClass(std::size_t sizeClass)
+{
+    return heap.allocateSizeClass(sizeClass);
+}
+
+void* allocateZeroed(std::size_t size)
+{
+    return heap.allocateZeroed(size);
+}
+
+void* allocateCritical(std::size_t size)
+{
+    return heap.allocateCritical(size);
+}
+
+void* allocateAligned(std::size_t size, std::size_t alignment)
+{
+    return heap.allocateAligned(size, alignment);
+}
+
+bool allocateBatch(std::size_t size, void** ptrs, std::size_t count)
+{
+    return heap.allocateBatch(size, ptrs, count);
 }
 
 void release(void* ptr)
 {
-    zoneAllocator.release(ptr);
+    heap.release(ptr);
+}
+
+void release(void* ptr, std::size_t size)
+{
+    heap.release(ptr, size);
+}
+
+void releaseSizeClass(void* ptr, std::size_t sizeClass)
+{
+    heap.releaseSizeClass(ptr, sizeClass);
+}
+
+void releaseBatch(void** ptrs, std::size_t count)
+{
+    heap.releaseBatch(ptrs, count);
+}
+
+void* reallocate(void* ptr, std::size_t size)
+{
+    return heap.reallocate(ptr, size);
+}
+
+std::size_t usableSize(void* ptr)
+{
+    return heap.usableSize(ptr);
+}
+
+Cache* cacheCreate(const char* name, std::size_t size, std::size_t alignment, const CacheHooks& hooks)
+{
+    return heap.cacheCreate(name, size, alignment, hooks);
 }
 
 Stats getStats()
 {
-    PageAllocator::Stats pageStats = pageAllocator.getStats();
-    ZoneAllocator::Stats zoneStats = zoneAllocator.getStats();
-
-    Stats stats{};
-    stats.totalMemorySize = pageStats.totalMemorySize;
-    stats.reservedMemorySize = pageStats.totalMemorySize - pageStats.effectiveMemorySize // Lost due to the alignment.
-                             + pageStats.reservedPagesCount * pageStats.pageSize // Reserved by the PageAllocator.
-                             + zoneStats.reservedMemorySize;                     // Reserved by the ZoneAllocator.
-    stats.userMemorySize = stats.totalMemorySize - stats.reservedMemorySize;
-    stats.allocatedMemorySize = pageStats.userMemorySize - pageStats.freeMemorySize
-                              - zoneStats.usedMemorySize       // Allocated from PageAllocator by user.
-                              + zoneStats.allocatedMemorySize; // Allocated from ZoneAllocator by user.
-    stats.freeMemorySize = stats.userMemorySize - stats.allocatedMemorySize;
-
-    return stats;
+    return heap.getStats();
+}
+
+std::pmr::memory_resource* memoryResource()
+{
+    // NOLINTNEXTLINE(fuchsia-statically-constructed-objects)
+    static HeapResource resource(heap);
+    return &resource;
 }
 
 } // namespace memory::allocator
@@ -35,17 +35,12 @@
 #include "Page.hpp"
 
 #include <cassert>
-#include <cmath>
 
 namespace memory {
 
-std::size_t groupIdx(std::size_t pageCount)
-{
-    if (pageCount < 2)
-        return 0;
-
-    return static_cast<std::size_t>(std::floor(std::log2(pageCount)) - 1);
-}
+static_assert(groupIdx(0) == 0 && groupIdx(1) == 0 && groupIdx(2) == 0 && groupIdx(3) == 0, "invalid group index");
+static_assert(groupIdx(4) == 1 && groupIdx(7) == 1 && groupIdx(8) == 2, "invalid group index");
+static_assert(groupIdx(std::size_t(1) << 20U) == 19, "invalid group index");
 
 void initGroup(Page* group, std::size_t groupSize)
 {
@@ -53,6 +48,7 @@ void initGroup(Page* group, std::size_t groupSize)
 
     Page* firstPage = group;
     Page* lastPage = group + groupSize - 1;
+    firstPage->initListNode();
     firstPage->setGroupSize(groupSize);
     lastPage->setGroupSize(groupSize);
 }
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include "utils.hpp"
+
 #include <cstddef>
 #include <tuple>
 
@@ -42,11 +44,15 @@ class Page;
 /// Calculates index in the groups array, for which group with the given page count should be stored.
 /// @param pageCount        Number of pages, for which index should be calculated.
 /// @return Index in the groups array.
-std::size_t groupIdx(std::size_t pageCount);
+constexpr std::size_t groupIdx(std::size_t pageCount)
+{
+    return (pageCount < 2) ? 0 : utils::log2(pageCount) - 1;
+}
 
 /// Initializes the given group.
 /// @param group            Group to be initialized.
 /// @param groupSize        Size of the initialized group.
+/// @note Group must not be a part of any list, because its list node is initialized too.
 void initGroup(Page* group, std::size_t groupSize);
 
 /// Clears the given group.
@@ -0,0 +1,137 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+class Heap;
+
+/// Represents a monotonic arena, that allocates memory by bumping a pointer within blocks of pages taken from a heap.
+/// @note Memory allocated from the arena cannot be released individually. Instead the whole arena can be reset or
+///       rewound to the previously taken marker, which returns the blocks of pages to the heap in bulk.
+class Arena {
+public:
+    /// Represents a position in the arena, to which the arena can be rewound.
+    struct Marker {
+        void* block;           ///< Block, that was current when the marker was taken.
+        std::uintptr_t cursor; ///< Position of the allocation cursor when the marker was taken.
+    };
+
+    /// Constructor.
+    /// @param heap         Heap to be used as the source of the blocks.
+    /// @param blockSize    Minimal size of the block taken from the heap. It is rounded up to the page size.
+    explicit Arena(Heap& heap, std::size_t blockSize = 0) noexcept;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Arena is not meant to be copy-constructed.
+    Arena(const Arena&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Arena is not meant to be move-constructed.
+    Arena(Arena&&) = delete;
+
+    /// Destructor.
+    /// @note All blocks owned by the arena are returned to the heap.
+    ~Arena();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Arena is not meant to be copy-assigned.
+    Arena& operator=(const Arena&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Arena is not meant to be move-assigned.
+    Arena& operator=(Arena&&) = delete;
+
+    /// Allocates memory block with the given size and alignment.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block. It must be a power of 2.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Allocation of 0 bytes always fails, regardless of the state of the current block.
+    [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        auto addr = (m_cursor + alignment - 1) & ~(alignment - 1);
+        if (size != 0 && addr >= m_cursor && addr <= m_end && size <= m_end - addr) [[likely]] {
+            m_cursor = addr + size;
+            return reinterpret_cast<void*>(addr); // NOLINT(performance-no-int-to-ptr)
+        }
+
+        return allocateBlock(size, alignment);
+    }
+
+    /// Returns the marker describing the current position in the arena.
+    /// @return Marker of the current position in the arena.
+    [[nodiscard]] Marker mark() const { return {m_block, m_cursor}; }
+
+    /// Releases all memory allocated after the given marker has been taken.
+    /// @param marker       Marker to which arena should be rewound.
+    /// @note Blocks taken after the marker are returned to the heap.
+    void rewind(const Marker& marker);
+
+    /// Releases all memory allocated from the arena and returns all blocks to the heap.
+    void reset();
+
+    /// Returns the number of blocks currently owned by the arena.
+    /// @return Number of blocks owned by the arena.
+    [[nodiscard]] std::size_t blocksCount() const;
+
+private:
+    /// Represents the header placed at the beginning of each block.
+    struct Block {
+        Block* prev;      ///< Previously allocated block.
+        std::size_t size; ///< Size of the block including the header.
+    };
+
+    /// Allocates new block from the heap and allocates the given memory from it.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    void* allocateBlock(std::size_t size, std::size_t alignment);
+
+private:
+    Heap* m_heap;              ///< Heap used as the source of the blocks.
+    std::size_t m_blockSize;   ///< Minimal size of the block taken from the heap.
+    Block* m_block{};          ///< Current block, from which memory is allocated.
+    std::uintptr_t m_cursor{}; ///< Address of the first free byte in the current block.
+    std::uintptr_t m_end{};    ///< Address of the end of the current block.
+};
+
+} // namespace memory
@@ -0,0 +1,304 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Region.hpp"
+#include "allocator.hpp"
+#include "config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+class Cache;
+class PageProvider;
+struct CacheHooks;
+
+/// Represents an independent heap, that manages its own set of memory regions.
+/// @note Each heap has its own page and zone allocators, so allocations from different heaps never interfere.
+class Heap {
+public:
+    /// Default constructor.
+    Heap() noexcept;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because Heap is not meant to be copy-constructed.
+    Heap(const Heap&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because Heap is not meant to be move-constructed.
+    Heap(Heap&&) = delete;
+
+    /// Destructor.
+    /// @note Regions obtained from the page provider are given back to it.
+    ~Heap();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Heap is not meant to be copy-assigned.
+    Heap& operator=(const Heap&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because Heap is not meant to be move-assigned.
+    Heap& operator=(Heap&&) = delete;
+
+    /// Initializes the heap with the given array of memory regions and page size.
+    /// @param regions      Array of memory regions to be used by the heap. Last entry should be zeroed.
+    /// @param pageSize     Size of the page on the current platform.
+    /// @param zeroed       Flag indicating if the given regions are known to contain only zeros (e.g. fresh mmap).
+    /// @return Result of the initialization.
+    /// @retval true        Heap has been initialized.
+    /// @retval false       Some error occurred.
+    [[nodiscard]] bool init(Region* regions, std::size_t pageSize, bool zeroed = false);
+
+    /// Initializes the heap with the given memory boundaries and page size.
+    /// @param start        Start address of a memory region to be used by the heap.
+    /// @param end          End address of a memory region to be used by the heap.
+    /// @param pageSize     Size of the page on the current platform.
+    /// @param zeroed       Flag indicating if the given memory is known to contain only zeros (e.g. fresh mmap).
+    /// @return Result of the initialization.
+    /// @retval true        Heap has been initialized.
+    /// @retval false       Some error occurred.
+    /// @note This overload is equivalent to the above version of init() with only one memory region entry.
+    [[nodiscard]] bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize, bool zeroed = false);
+
+    /// Adds the given memory region to the already initialized heap.
+    /// @param region       Memory region to be added.
+    /// @param zeroed       Flag indicating if the given region is known to contain only zeros (e.g. fresh mmap).
+    /// @return Result of the operation.
+    /// @retval true        Region has been added.
+    /// @retval false       Some error occurred.
+    /// @note Page descriptors of the added region are stored at its beginning.
+    [[nodiscard]] bool addRegion(const Region& region, bool zeroed = false);
+
+    /// Sets the page provider, that is asked for new regions, when the heap runs out of free pages.
+    /// @param provider         Page provider to be used or nullptr to disable growing. It has to outlive the heap.
+    /// @param directThreshold  Minimal size of the allocation, which is served from a dedicated region obtained from
+    ///                         the provider. Value 0 disables direct allocations.
+    /// @note Each region obtained from the provider is as big as all regions currently in use by the heap, so that
+    ///       the memory doubles with every growth. Regions, that become completely free, are given back to the
+    ///       provider. One empty region is kept until trim(), so that allocations oscillating at its boundary do
+    ///       not obtain it again.
+    /// @note Provider is detached by clear() and init(), so it has to be set after the heap is initialized.
+    void setPageProvider(PageProvider* provider, std::size_t directThreshold = 0);
+
+    /// Sets the size of the free memory, above which the free pages are decommitted through the page provider.
+    /// @param threshold        Size of the free memory, that triggers decommit. Value 0 disables automatic decommit.
+    /// @note Threshold is reset by clear() and init(), so it has to be set after the heap is initialized.
+    void setDecommitThreshold(std::size_t threshold);
+
+    /// Gives the empty regions and the physical memory of all free pages back to the system through the page provider.
+    /// @return Size of the memory, that has been given back.
+    /// @note Free chunks inside of the zones are not decommitted, because their pages are still in use.
+    std::size_t trim();
+
+    /// Sets the size of the emergency reserve, that only allocateCritical() can use.
+    /// @param size             Size of the reserve. It is rounded up to the page size. Value 0 disables the reserve.
+    /// @note Reserve is the number of free pages, that normal allocations have to leave, so it does not protect
+    ///       the free chunks of the existing zones.
+    /// @note Reserve is reset by clear() and init(), so it has to be set after the heap is initialized.
+    void setEmergencyReserve(std::size_t size);
+
+    /// Sets the watermarks of the free memory, that control reclaiming memory from the shrinkers.
+    /// @param low              Size of the free memory, below which memory is reclaimed, once the allocation, that
+    ///                         has crossed it, returns. Value 0 disables it.
+    /// @param high             Size of the free memory, up to which memory is reclaimed.
+    /// @note Before an allocation fails, memory is always reclaimed. Empty zones retained by the object caches are
+    ///       released first, and then the shrinkers are called in the order of registration.
+    /// @note Watermarks are reset by clear() and init(), so they have to be set after the heap is initialized.
+    void setWatermarks(std::size_t low, std::size_t high);
+
+    /// Registers the given shrinker, that is asked to release memory, when the free memory runs low.
+    /// @param shrinker         Shrinker to be registered.
+    /// @return Flag indicating if the shrinker has been registered.
+    /// @note Shrinker may release memory to the heap. Shrinkers called because of the low watermark run only after
+    ///       the allocation, that has crossed it, returns, so they may also allocate from the heap. Shrinkers called
+    ///       before an allocation fails run in the middle of it, so they should not allocate.
+    /// @note Shrinkers are unregistered by clear() and init(), so they have to be added after the heap is initialized.
+    [[nodiscard]] bool addShrinker(const allocator::Shrinker& shrinker);
+
+    /// Unregisters the given shrinker.
+    /// @param shrinker         Shrinker to be unregistered.
+    void removeShrinker(const allocator::Shrinker& shrinker);
+
+    /// Clears the internal state of the heap and detaches it from its memory regions.
+    /// @note This function works in time proportional to the number of regions, not to the number of allocations.
+    /// @note Regions obtained from the page provider are given back to it.
+    void clear();
+
+    /// Releases all memory blocks allocated from the heap at once, while keeping its memory regions.
+    /// @return Result of the reset.
+    /// @retval true        Heap has been reset.
+    /// @retval false       Some error occurred.
+    /// @note This function works in time proportional to the number of regions, not to the number of allocations.
+    bool reset();
+
+    /// Allocates memory block with the given size.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] void* allocate(std::size_t size);
+
+    /// Allocates memory block with at least the given size and returns its real size.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Allocated memory block with its real size on success or {nullptr, 0} on failure.
+    /// @note This is equivalent to C++23 allocate_at_least(). Whole returned size can be used by the caller.
+    [[nodiscard]] allocator::AllocationResult allocateAtLeast(std::size_t size);
+
+    /// Allocates memory block from the given size class.
+    /// @param sizeClass    Size class returned by allocator::sizeClass() for the demanded size.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] void* allocateSizeClass(std::size_t sizeClass);
+
+    /// Allocates memory block with the given size and fills it with zeros.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Pages, that were never allocated from the heap initialized with zeroed memory, are not cleared again.
+    [[nodiscard]] void* allocateZeroed(std::size_t size);
+
+    /// Allocates memory block with the given size, that can use the emergency reserve if there is no other free memory.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Reserve is used only after the page provider and the shrinkers have failed to provide the memory.
+    [[nodiscard]] void* allocateCritical(std::size_t size);
+
+    /// Allocates memory block with the given size and alignment.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block. It must be a power of 2.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Allocated memory block can be released with any version of release().
+    [[nodiscard]] void* allocateAligned(std::size_t size, std::size_t alignment);
+
+    /// Allocates the given number of memory blocks with the given size.
+    /// @param size         Demanded size of each allocated memory block.
+    /// @param ptrs         Array, to which allocated memory blocks should be stored.
+    /// @param count        Number of memory blocks to be allocated.
+    /// @return Result of the allocation.
+    /// @retval true        All memory blocks have been allocated.
+    /// @retval false       Some error occurred. No memory block is allocated in that case.
+    [[nodiscard]] bool allocateBatch(std::size_t size, void** ptrs, std::size_t count);
+
+    /// Releases the memory block pointed by given pointer.
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    void release(void* ptr);
+
+    /// Releases the memory block pointed by given pointer, that was allocated with the given size.
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @param size         Size, that was passed to allocate() for the given memory block.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    /// @note This version is faster than release(void*), because the size class is computed directly from the size.
+    ///       Passing different size than the one used in allocate() is checked with assertions in debug builds.
+    void release(void* ptr, std::size_t size);
+
+    /// Releases the memory block pointed by given pointer, that was allocated from the given size class.
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @param sizeClass    Size class, that was passed to allocateSizeClass() for the given memory block.
+    /// @note If the given pointer is nullptr, then function exists without an error.
+    void releaseSizeClass(void* ptr, std::size_t sizeClass);
+
+    /// Releases the given number of memory blocks.
+    /// @param ptrs         Array of pointers to the memory blocks, that should be released.
+    /// @param count        Number of memory blocks to be released.
+    /// @note Array may contain nullptr entries. Blocks allocated together should be released together.
+    void releaseBatch(void** ptrs, std::size_t count);
+
+    /// Changes the size of the memory block pointed by given pointer.
+    /// @param ptr          Pointer to the memory block, that should be resized.
+    /// @param size         Demanded size of the memory block.
+    /// @return Result of the reallocation.
+    /// @retval void*       Resized memory block on success. Its content is preserved up to the lesser of the sizes.
+    /// @retval nullptr     Some error occurred. The given memory block is left untouched.
+    /// @note If the given pointer is nullptr, then function is equivalent to allocate(size).
+    /// @note If the given size is 0, then function is equivalent to release(ptr) and returns nullptr.
+    /// @note Memory block is resized in place whenever possible, so no copying is needed.
+    [[nodiscard]] void* reallocate(void* ptr, std::size_t size);
+
+    /// Returns the real size of the memory block pointed by given pointer.
+    /// @param ptr          Pointer to the memory block returned by one of the allocation functions.
+    /// @return Size of the memory block, that can be used by the caller.
+    /// @note This function works in constant time. It returns 0 for nullptr.
+    std::size_t usableSize(void* ptr);
+
+    /// Creates the cache of objects with the given size and alignment.
+    /// @param name         Name of the cache. It has to outlive the cache.
+    /// @param size         Size of the objects. It does not have to be a power of 2.
+    /// @param alignment    Alignment of the objects. It must be a power of 2.
+    /// @param hooks        Hooks to be called on the objects. Each of them can be nullptr.
+    /// @return Result of the creation.
+    /// @retval Cache*      Created cache on success.
+    /// @retval nullptr     Some error occurred.
+    /// @note Objects are packed with their exact size into pages taken from the heap. Cache has to be destroyed before
+    ///       the heap is reset or cleared.
+    [[nodiscard]] Cache*
+    cacheCreate(const char* name, std::size_t size, std::size_t alignment, const CacheHooks& hooks);
+
+    /// Returns the current statistics of the heap.
+    /// @return Heap statistics.
+    allocator::Stats getStats();
+
+    /// Returns size of the page used by the heap.
+    /// @return Size of the page used by the heap.
+    /// @note Allocations bigger than half of the page (or than the biggest size class, if it is smaller) are served
+    ///       with the continuous set of pages. Allocations of at least the direct threshold given to setPageProvider()
+    ///       are served from dedicated regions obtained from the provider.
+    std::size_t pageSize();
+
+private:
+    struct Impl;
+
+    /// Returns the internal state of the heap.
+    /// @return Internal state of the heap.
+    Impl& impl();
+
+private:
+    /// Size of the internal state. Each supported memory region takes 12 words of it.
+    static constexpr std::size_t m_cStorageSize = (96 + 12 * config::cMaxRegionsCount) * sizeof(std::uintptr_t);
+
+private:
+    alignas(std::max_align_t) std::array<std::byte, m_cStorageSize> m_storage{}; ///< Storage of the internal state.
+};
+
+} // namespace memory
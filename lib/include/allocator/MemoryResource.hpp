@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+namespace memory {
+namespace detail {
+
+/// Reports the failure of the allocation made through the standard allocator interfaces.
+/// @note std::bad_alloc is thrown, when exceptions are enabled, otherwise the program is terminated.
+[[noreturn]] inline void allocationFailed()
+{
+#ifdef __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+} // namespace detail
+
+class Arena;
+class Heap;
+
+/// Represents the std::pmr::memory_resource, that allocates memory from the given heap.
+/// @note Size passed by the pmr containers to deallocate() is used to release the memory without the owner lookup.
+class HeapResource : public std::pmr::memory_resource {
+public:
+    /// Constructor.
+    /// @param heap         Heap to be used as the source of the memory.
+    explicit HeapResource(Heap& heap) noexcept;
+
+    /// Returns the heap used by this resource.
+    /// @return Heap used by this resource.
+    [[nodiscard]] Heap& heap() const;
+
+private:
+    /// Allocates memory block with the given size and alignment.
+    /// @param bytes        Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Allocated memory block.
+    /// @note On failure std::bad_alloc is thrown or the program is terminated, when exceptions are disabled.
+    /// @note Alignments bigger than the page size are served by Heap::allocateAligned().
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    /// Releases the given memory block.
+    /// @param ptr          Pointer to the memory block, that should be released.
+    /// @param bytes        Size, that was used to allocate the given memory block.
+    /// @param alignment    Alignment, that was used to allocate the given memory block.
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+    /// Checks if memory allocated from this resource can be released by the other one.
+    /// @param other        Resource to be compared with.
+    /// @return Flag indicating if both resources are interchangeable.
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    Heap* m_heap; ///< Heap used as the source of the memory.
+};
+
+/// Represents the std::pmr::memory_resource, that allocates memory from the given arena.
+/// @note Deallocation is a no-op. Memory is given back only when the arena is reset or rewound.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    /// Constructor.
+    /// @param arena        Arena to be used as the source of the memory.
+    explicit ArenaResource(Arena& arena) noexcept;
+
+    /// Returns the arena used by this resource.
+    /// @return Arena used by this resource.
+    [[nodiscard]] Arena& arena() const;
+
+private:
+    /// Allocates memory block with the given size and alignment.
+    /// @param bytes        Demanded size of the allocated memory block.
+    /// @param alignment    Demanded alignment of the allocated memory block.
+    /// @return Allocated memory block.
+    /// @note On failure std::bad_alloc is thrown or the program is terminated, when exceptions are disabled.
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    /// Does nothing, because arena does not release individual memory blocks.
+    void do_deallocate(void* /*unused*/, std::size_t /*unused*/, std::size_t /*unused*/) override {}
+
+    /// Checks if memory allocated from this resource can be released by the other one.
+    /// @param other        Resource to be compared with.
+    /// @return Flag indicating if both resources are interchangeable.
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    Arena* m_arena; ///< Arena used as the source of the memory.
+};
+
+namespace allocator {
+
+/// Returns the std::pmr::memory_resource, that allocates memory from liballocator.
+/// @return Memory resource backed by liballocator.
+/// @note Returned resource is valid for the whole lifetime of the program.
+std::pmr::memory_resource* memoryResource();
+
+} // namespace allocator
+} // namespace memory
@@ -0,0 +1,108 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PageProvider.hpp"
+
+#include <cstddef>
+
+namespace memory {
+
+/// Represents the page provider, that maps anonymous memory from the operating system (Linux only).
+/// @note Address space is reserved without the swap reservation, so physical memory is used only for touched pages.
+class MmapPageProvider : public PageProvider {
+public:
+    /// Constructor.
+    /// @param lazyFree     Flag indicating if the decommitted memory is reclaimed lazily with MADV_FREE, which is
+    ///                     cheaper, but does not drop the resident size until the system runs short of memory.
+    /// @param hugePages    Flag indicating if the regions should be backed by huge pages. Reserved pool of huge pages
+    ///                     (MAP_HUGETLB) is used if it has enough of them, otherwise regions are aligned to the huge
+    ///                     page size and marked with MADV_HUGEPAGE for the transparent huge pages.
+    explicit MmapPageProvider(bool lazyFree = false, bool hugePages = false) noexcept;
+
+    /// Obtains the new memory region with at least the given size.
+    /// @param size         Demanded size of the region. It is rounded up to the huge page size if they are used.
+    /// @return Obtained region. Region with size equal to 0 means, that mmap() has failed.
+    [[nodiscard]] Region allocate(std::size_t size) override;
+
+    /// Unmaps the region, that has been previously obtained with allocate().
+    /// @param region       Region to be unmapped.
+    void release(const Region& region) override;
+
+    /// Checks if the obtained regions are known to contain only zeros.
+    /// @return Always true, because fresh anonymous mappings contain only zeros.
+    [[nodiscard]] bool isZeroed() const override { return true; }
+
+    /// Moves the given range to the given address with mremap(), so that only the page tables are moved.
+    /// @param from         Range from one of the obtained regions aligned to the system page size.
+    /// @param to           Address from another obtained region aligned to the system page size.
+    /// @return Result of the operation.
+    /// @retval true        Range has been moved. Its previous location is unmapped.
+    /// @retval false       Range is not properly aligned or mremap() has failed.
+    [[nodiscard]] bool move(const Region& from, std::uintptr_t to) override;
+
+    /// Gives the physical memory of the given range back to the system with madvise().
+    /// @param region       Range from one of the obtained regions aligned to decommitAlignment().
+    /// @return Result of the operation.
+    /// @retval true        Range has been decommitted.
+    /// @retval false       Range is not properly aligned or madvise() has failed.
+    [[nodiscard]] bool decommit(const Region& region) override;
+
+    /// Returns the alignment of the ranges, that can be decommitted.
+    /// @return System page size or huge page size, so that decommit never splits the huge pages.
+    [[nodiscard]] std::size_t decommitAlignment() const override;
+
+    /// Checks if the decommitted ranges are known to contain only zeros, when they are used again.
+    /// @return True for MADV_DONTNEED, false for MADV_FREE, after which the old content may still be present.
+    [[nodiscard]] bool isZeroedAfterDecommit() const override { return !m_lazyFree; }
+
+    /// Returns the size of the huge page used to back the regions.
+    /// @return Size of the huge page.
+    static constexpr std::size_t hugePageSize()
+    {
+        constexpr std::size_t cHugePageSize = 2 * 1024 * 1024;
+        return cHugePageSize;
+    }
+
+private:
+    /// Maps the region with the given size aligned to the huge page size.
+    /// @param size         Size of the region. It must be a multiple of the huge page size.
+    /// @return Mapped region. Region with size equal to 0 means, that mmap() has failed.
+    [[nodiscard]] static Region allocateHuge(std::size_t size);
+
+private:
+    bool m_lazyFree;  ///< Flag indicating if MADV_FREE is used instead of MADV_DONTNEED.
+    bool m_hugePages; ///< Flag indicating if the regions are backed by huge pages.
+};
+
+} // namespace memory
@@ -0,0 +1,174 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Heap.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace memory {
+
+class Cache;
+
+/// Represents the set of optional hooks called on the objects managed by the cache.
+/// @note Hooks are called with the object and the user argument stored in this structure.
+struct CacheHooks {
+    void (*ctor)(void* object, void* arg); ///< Called on each allocation of the object.
+    void (*dtor)(void* object, void* arg); ///< Called on each release of the object.
+    void (*init)(void* object, void* arg); ///< Called once, when the object is brought into the cache.
+    void (*fini)(void* object, void* arg); ///< Called once, when the object is removed from the cache.
+    void* arg;                             ///< User argument passed to each hook.
+};
+
+/// Allocates one object from the given cache.
+/// @param cache        Cache, from which object should be allocated.
+/// @return Result of the allocation.
+/// @retval void*       Allocated object on success.
+/// @retval nullptr     Some error occurred.
+/// @note Object has already been passed to the init hook, so it keeps the state left by the previous release.
+[[nodiscard]] void* cacheAllocate(Cache* cache);
+
+/// Releases the given object to the given cache.
+/// @param cache        Cache, from which object was allocated.
+/// @param object       Object to be released.
+/// @note If the given object is nullptr, then function exists without an error.
+/// @note Object stays in the cache in its current state. It is passed to the fini hook only when its page is given
+///       back to the heap.
+void cacheRelease(Cache* cache, void* object);
+
+/// Destroys the given cache and gives all its pages back to the heap.
+/// @param cache        Cache to be destroyed.
+/// @return Result of the operation.
+/// @retval true        Cache has been destroyed.
+/// @retval false       Some objects are still allocated from the cache, so it has been left untouched.
+/// @note If the given cache is nullptr, then function exists without an error.
+bool cacheDestroy(Cache* cache);
+
+namespace allocator {
+
+/// Creates the cache of objects with the given size and alignment in the global heap.
+/// @param name         Name of the cache. It has to outlive the cache.
+/// @param size         Size of the objects. It does not have to be a power of 2.
+/// @param alignment    Alignment of the objects. It must be a power of 2.
+/// @param hooks        Hooks to be called on the objects. Each of them can be nullptr.
+/// @return Result of the creation.
+/// @retval Cache*      Created cache on success.
+/// @retval nullptr     Some error occurred.
+[[nodiscard]] Cache* cacheCreate(const char* name, std::size_t size, std::size_t alignment, const CacheHooks& hooks);
+
+} // namespace allocator
+
+/// Represents the cache of objects of the given type.
+/// @note Objects are constructed once, when they are brought into the cache, and destroyed when their page is given
+///       back to the heap. User is responsible for leaving the released objects in a reusable state.
+template <typename T>
+class ObjectCache {
+public:
+    /// Constructor. Creates the cache in the global heap.
+    /// @param name         Name of the cache. It has to outlive the cache.
+    explicit ObjectCache(const char* name) noexcept
+        : m_cache(allocator::cacheCreate(name, sizeof(T), alignof(T), hooks()))
+    {}
+
+    /// Constructor. Creates the cache in the given heap.
+    /// @param heap         Heap to be used as the source of the memory.
+    /// @param name         Name of the cache. It has to outlive the cache.
+    ObjectCache(Heap& heap, const char* name) noexcept
+        : m_cache(heap.cacheCreate(name, sizeof(T), alignof(T), hooks()))
+    {}
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because ObjectCache is not meant to be copy-constructed.
+    ObjectCache(const ObjectCache&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because ObjectCache is not meant to be move-constructed.
+    ObjectCache(ObjectCache&&) = delete;
+
+    /// Destructor.
+    /// @note All objects have to be released to the cache before it is destroyed. Otherwise the cache is left in the
+    ///       heap together with its objects.
+    ~ObjectCache()
+    {
+        if (m_cache != nullptr)
+            cacheDestroy(m_cache);
+    }
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because ObjectCache is not meant to be copy-assigned.
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because ObjectCache is not meant to be move-assigned.
+    ObjectCache& operator=(ObjectCache&&) = delete;
+
+    /// Checks if the cache has been successfully created.
+    /// @return Flag indicating if the cache has been created.
+    /// @retval true        Cache has been created.
+    /// @retval false       Some error occurred.
+    [[nodiscard]] bool isValid() const { return m_cache != nullptr; }
+
+    /// Allocates one constructed object from the cache.
+    /// @return Result of the allocation.
+    /// @retval T*          Allocated object on success.
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] T* allocate() { return std::launder(static_cast<T*>(cacheAllocate(m_cache))); }
+
+    /// Releases the given object to the cache without destroying it.
+    /// @param object       Object to be released.
+    void release(T* object) { cacheRelease(m_cache, object); }
+
+private:
+    /// Returns the hooks, that construct and destroy the objects of type T.
+    /// @return Hooks to be used by the cache.
+    /// @note Trivial types need no hooks, so their free list can overlap the released objects.
+    static CacheHooks hooks()
+    {
+        CacheHooks cacheHooks{};
+        if constexpr (!std::is_trivially_default_constructible_v<T> || !std::is_trivially_destructible_v<T>) {
+            cacheHooks.init = [](void* object, void* /*unused*/) { new (object) T(); };
+            cacheHooks.fini = [](void* object, void* /*unused*/) { std::launder(static_cast<T*>(object))->~T(); };
+        }
+
+        return cacheHooks;
+    }
+
+private:
+    Cache* m_cache; ///< Cache used to allocate the objects.
+};
+
+} // namespace memory
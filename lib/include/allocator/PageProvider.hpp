@@ -0,0 +1,154 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Region.hpp"
+#include "config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+/// Represents the source of the memory regions, that is used by the heap when it runs out of the free pages.
+/// @note Regions obtained from the provider, which become completely free, are given back to it.
+class PageProvider {
+public:
+    /// Default constructor.
+    constexpr PageProvider() = default;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because PageProvider is not meant to be copy-constructed.
+    PageProvider(const PageProvider&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because PageProvider is not meant to be move-constructed.
+    PageProvider(PageProvider&&) = delete;
+
+    /// Destructor.
+    virtual ~PageProvider() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because PageProvider is not meant to be copy-assigned.
+    PageProvider& operator=(const PageProvider&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because PageProvider is not meant to be move-assigned.
+    PageProvider& operator=(PageProvider&&) = delete;
+
+    /// Obtains the new memory region with at least the given size.
+    /// @param size         Demanded size of the region.
+    /// @return Obtained region. Region with size equal to 0 means, that some error occurred.
+    [[nodiscard]] virtual Region allocate(std::size_t size) = 0;
+
+    /// Gives back the region, that has been previously obtained with allocate().
+    /// @param region       Region to be given back.
+    virtual void release(const Region& region) = 0;
+
+    /// Checks if the obtained regions are known to contain only zeros.
+    /// @return Flag indicating if the obtained regions are zeroed.
+    [[nodiscard]] virtual bool isZeroed() const { return false; }
+
+    /// Moves the content of the given range to the given address without copying it (e.g. by moving page tables).
+    /// @param from         Page aligned range from one of the obtained regions, that should be moved.
+    /// @param to           Page aligned address from another obtained region, where the range should be placed.
+    /// @return Result of the operation.
+    /// @retval true        Range has been moved. Its previous location should not be accessed anymore.
+    /// @retval false       Range cannot be moved, so both locations are left untouched.
+    /// @note Default implementation does nothing, because plain memory can be moved only by copying.
+    [[nodiscard]] virtual bool move([[maybe_unused]] const Region& from, [[maybe_unused]] std::uintptr_t to)
+    {
+        return false;
+    }
+
+    /// Gives the physical memory of the given free range back to the system, while keeping its address space.
+    /// @param region       Page aligned range from one of the obtained regions.
+    /// @return Result of the operation.
+    /// @retval true        Range has been decommitted.
+    /// @retval false       Range cannot be decommitted, so it stays committed.
+    /// @note Default implementation does nothing, because plain memory cannot be given back to anyone.
+    [[nodiscard]] virtual bool decommit([[maybe_unused]] const Region& region) { return false; }
+
+    /// Returns the alignment of the ranges, that can be decommitted.
+    /// @return Alignment of the decommitted ranges. Value 0 means, that any range of whole heap pages can be used.
+    [[nodiscard]] virtual std::size_t decommitAlignment() const { return 0; }
+
+    /// Makes the given range, that has been decommitted before, usable again.
+    /// @param region       Page aligned range, that is about to be handed out.
+    /// @note Default implementation does nothing, which is enough for the systems, that commit memory on first touch.
+    virtual void commit([[maybe_unused]] const Region& region) {}
+
+    /// Checks if the decommitted ranges are known to contain only zeros, when they are used again.
+    /// @return Flag indicating if the decommitted ranges are zeroed.
+    [[nodiscard]] virtual bool isZeroedAfterDecommit() const { return false; }
+};
+
+/// Represents the page provider, that carves the regions out of the single static memory pool (e.g. on bare metal).
+/// @note Released regions are reused by the next allocations, that fit into them. Regions released from the end of
+///       the pool are merged back into it.
+class StaticPageProvider : public PageProvider {
+public:
+    /// Constructor.
+    /// @param start        Start address of the memory pool.
+    /// @param end          End address of the memory pool.
+    StaticPageProvider(std::uintptr_t start, std::uintptr_t end) noexcept;
+
+    /// Obtains the new memory region with at least the given size.
+    /// @param size         Demanded size of the region.
+    /// @return Obtained region. Region with size equal to 0 means, that the pool is exhausted.
+    [[nodiscard]] Region allocate(std::size_t size) override;
+
+    /// Gives back the region, that has been previously obtained with allocate().
+    /// @param region       Region to be given back.
+    void release(const Region& region) override;
+
+    /// Returns the size of the pool, that has never been handed out or has been merged back into it.
+    /// @return Size of the remaining part of the pool.
+    [[nodiscard]] std::size_t remainingSize() const;
+
+private:
+    /// Represents the region handed out from the pool.
+    struct Slot {
+        Region region; ///< Region handed out from the pool.
+        bool used;     ///< Flag indicating if the region is currently used.
+    };
+
+    std::array<Slot, config::cMaxRegionsCount> m_slots{}; ///< Regions handed out from the pool in address order.
+    std::size_t m_slotsCount{};                           ///< Number of regions handed out from the pool.
+    std::uintptr_t m_cursor;                              ///< Address of the first byte never handed out.
+    std::uintptr_t m_end;                                 ///< End address of the memory pool.
+};
+
+} // namespace memory
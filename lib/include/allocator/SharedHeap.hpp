@@ -0,0 +1,238 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "allocator.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+/// Represents a heap, that keeps all its state inside of the managed memory, so that it can be shared between
+/// processes, which map the same memory (e.g. memfd or POSIX shared memory) at different addresses.
+/// @note All internal links are stored as offsets from the beginning of the heap, so the heap does not depend on the
+///       address at which it is mapped. Operations are serialized with a spin lock built on a lock-free atomic flag,
+///       which works across processes. Process, that dies while holding the lock, leaves the heap locked until it is
+///       recovered. When the memory is backed by a file, the heap with all its objects survives restarts of processes.
+class SharedHeap {
+public:
+    /// Represents a position-independent reference to the memory block allocated from the heap.
+    using Offset = std::uint64_t;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because SharedHeap is not meant to be copy-constructed.
+    SharedHeap(const SharedHeap&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because SharedHeap is not meant to be move-constructed.
+    SharedHeap(SharedHeap&&) = delete;
+
+    /// Destructor.
+    ~SharedHeap() = default;
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because SharedHeap is not meant to be copy-assigned.
+    SharedHeap& operator=(const SharedHeap&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because SharedHeap is not meant to be move-assigned.
+    SharedHeap& operator=(SharedHeap&&) = delete;
+
+    /// Creates new heap at the beginning of the given memory. The whole memory is managed by the heap.
+    /// @param memory       Memory to be managed by the heap. It must be aligned to alignof(std::max_align_t).
+    /// @param size         Size of the memory.
+    /// @return Result of the creation.
+    /// @retval SharedHeap* Heap created in the given memory on success.
+    /// @retval nullptr     Memory is misaligned or too small.
+    /// @note Previous content of the memory is discarded.
+    static SharedHeap* create(void* memory, std::size_t size);
+
+    /// Attaches to the heap, that has already been created in the given memory (possibly by another process).
+    /// @param memory       Memory containing the heap. It can be mapped at a different address than during creation.
+    /// @param size         Size of the mapped memory.
+    /// @return Result of the attaching.
+    /// @retval SharedHeap* Heap found in the given memory on success.
+    /// @retval nullptr     Memory does not contain a valid heap or the heap does not fit into the given size.
+    /// @note Each successful call should be paired with detach().
+    /// @note Lock held by a process, that has died, is never released, so attach() would wait for it forever. After
+    ///       any user of the heap has exited without detach(), recover() must be called instead.
+    static SharedHeap* attach(void* memory, std::size_t size);
+
+    /// Attaches to the heap, that has been left in the given memory by processes, which are no longer running.
+    /// If any of them has not detached cleanly, the blocks are scanned, free lists are rebuilt and the lock is reset.
+    /// @param memory       Memory containing the heap. It can be mapped at a different address than during creation.
+    /// @param size         Size of the mapped memory.
+    /// @return Result of the recovery.
+    /// @retval SharedHeap* Recovered heap on success.
+    /// @retval nullptr     Memory does not contain a valid heap, the heap does not fit into the given size or the
+    ///                     blocks are corrupted.
+    /// @note No other process may use the heap during the recovery.
+    static SharedHeap* recover(void* memory, std::size_t size);
+
+    /// Detaches the current process from the heap. When the last process detaches, heap is marked as consistent.
+    /// @note Heap must not be used by the current process after this call.
+    void detach();
+
+    /// Returns the number of processes attached to the heap.
+    /// @return Number of processes attached to the heap.
+    /// @note Nonzero value found by a process, that has just started, means that the previous users exited uncleanly.
+    [[nodiscard]] std::size_t attachedCount();
+
+    /// Sets the root object of the heap, from which all objects can be reached again after attaching.
+    /// @param offset       Offset of the root object returned by toOffset().
+    void setRoot(Offset offset);
+
+    /// Returns the root object of the heap.
+    /// @return Offset of the root object or 0 if it has not been set.
+    [[nodiscard]] Offset root();
+
+    /// Allocates memory block with the given size.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success, aligned to alignof(std::max_align_t).
+    /// @retval nullptr     Some error occurred.
+    [[nodiscard]] void* allocate(std::size_t size);
+
+    /// Releases the given memory block. It may have been allocated through another mapping of the heap.
+    /// @param ptr          Memory block to be released.
+    void release(void* ptr);
+
+    /// Returns the usable size of the given memory block, which is not less than the demanded size.
+    /// @param ptr          Memory block allocated from the heap.
+    /// @return Usable size of the given memory block.
+    [[nodiscard]] std::size_t usableSize(void* ptr) const;
+
+    /// Converts the given memory block into the offset, that can be passed to other processes.
+    /// @param ptr          Memory block allocated from the heap or nullptr.
+    /// @return Offset of the given memory block or 0 for nullptr.
+    [[nodiscard]] Offset toOffset(const void* ptr) const;
+
+    /// Converts the given offset into the memory block valid in the current mapping of the heap.
+    /// @param offset       Offset returned by toOffset() in any process.
+    /// @return Memory block at the given offset or nullptr for 0.
+    [[nodiscard]] void* fromOffset(Offset offset) const;
+
+    /// Returns the statistics of the heap.
+    /// @return Statistics of the heap.
+    /// @note Headers of the allocated blocks are counted as the allocated memory.
+    allocator::Stats getStats();
+
+private:
+    /// Represents the header placed in front of each block managed by the heap.
+    struct Block {
+        Offset size;     ///< Size of the block including the header. Lowest bit marks the used block.
+        Offset prevSize; ///< Size of the preceding block including its header or 0 for the first block.
+    };
+
+    /// Represents the links stored in the payload of the free blocks.
+    struct FreeLinks {
+        Offset next; ///< Offset of the next free block in the list or 0.
+        Offset prev; ///< Offset of the previous free block in the list or 0.
+    };
+
+    /// Constructor.
+    /// @param size         Size of the memory managed by the heap, including the heap object.
+    explicit SharedHeap(std::size_t size);
+
+    /// Finds the heap created in the given memory.
+    /// @param memory       Memory containing the heap.
+    /// @param size         Size of the mapped memory.
+    /// @return Result of the search.
+    /// @retval SharedHeap* Heap found in the given memory on success.
+    /// @retval nullptr     Memory is misaligned, does not contain a valid heap or the heap does not fit into it.
+    static SharedHeap* find(void* memory, std::size_t size);
+
+    /// Locks the heap against concurrent access from all threads and processes.
+    void lock();
+
+    /// Unlocks the heap.
+    void unlock();
+
+    /// Returns the block at the given offset.
+    /// @param offset       Offset of the block from the beginning of the heap.
+    /// @return Block at the given offset.
+    [[nodiscard]] Block* block(Offset offset) const;
+
+    /// Returns the free list links of the block at the given offset.
+    /// @param offset       Offset of the free block from the beginning of the heap.
+    /// @return Free list links of the given block.
+    [[nodiscard]] FreeLinks* links(Offset offset) const;
+
+    /// Inserts the given free block into the free list matching its size.
+    /// @param offset       Offset of the free block.
+    void addToFreeList(Offset offset);
+
+    /// Removes the given free block from the free list matching its size.
+    /// @param offset       Offset of the free block.
+    void removeFromFreeList(Offset offset);
+
+    /// Finds the free block, that is not smaller than the given size, and removes it from the free list.
+    /// @param size         Demanded size of the block including the header.
+    /// @return Offset of the found block or 0 if no block is big enough.
+    Offset takeFreeBlock(std::size_t size);
+
+    /// Stores the size word of the given block after all preceding stores of the current operation.
+    /// @param offset       Offset of the block.
+    /// @param size         Size of the block including the header and the used flag.
+    void publishSize(Offset offset, Offset size);
+
+    /// Updates the size of the preceding block recorded in the block following the given one.
+    /// @param offset       Offset of the block, which size has changed.
+    void updateNextBlock(Offset offset);
+
+    /// Rebuilds the free lists and boundary tags from the sizes of all blocks, coalescing adjacent free blocks.
+    /// @return Flag indicating if the blocks cover the whole heap without gaps.
+    bool rebuild();
+
+private:
+    static constexpr std::uint64_t m_cMagic = 0x6c69626170736870;                     ///< Marker of a valid heap.
+    static constexpr std::size_t m_cAlignment = alignof(std::max_align_t);            ///< Alignment of all blocks.
+    static constexpr std::uint64_t m_cUsedFlag = 1;                                   ///< Flag marking the used block.
+    static constexpr std::size_t m_cMinBlockSize = sizeof(Block) + sizeof(FreeLinks); ///< Minimal size of the block.
+    static constexpr std::size_t m_cFreeListsCount = 64;                              ///< Number of the free lists.
+
+    std::uint64_t m_magic{};                             ///< Marker of the initialized heap.
+    std::uint64_t m_size;                                ///< Size of the memory managed by the heap.
+    std::uint64_t m_freeSize{};                          ///< Total size of the free blocks including headers.
+    std::uint64_t m_attachedCount{};                     ///< Number of processes attached to the heap.
+    Offset m_root{};                                     ///< Offset of the root object.
+    std::atomic_flag m_lock;                             ///< Lock serializing operations on the heap.
+    std::array<Offset, m_cFreeListsCount> m_freeLists{}; ///< Free lists of blocks segregated by log2 of the size.
+};
+
+} // namespace memory
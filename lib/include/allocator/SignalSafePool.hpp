@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace memory {
+
+class Heap;
+
+/// Represents a set of small pools of blocks pre-reserved from a heap for every size class, that can be used from
+/// contexts, in which the heap cannot be used (e.g. signal handlers or interrupt service routines).
+/// @note Only allocate() and release() are async-signal-safe. They are lock-free and never touch the heap. Pools are
+///       refilled from the heap and surplus blocks are returned to it by refill(), which has to be called from the
+///       normal context under the same protection as every other operation on the heap.
+/// @note Lock-free operations require a lock-free 32-bit atomic compare-and-swap (e.g. LDREX/STREX on Cortex-M3).
+class SignalSafePool {
+public:
+    /// Constructor.
+    /// @param heap         Heap to be used as the source of the blocks.
+    explicit SignalSafePool(Heap& heap) noexcept;
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because SignalSafePool is not meant to be copy-constructed.
+    SignalSafePool(const SignalSafePool&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because SignalSafePool is not meant to be move-constructed.
+    SignalSafePool(SignalSafePool&&) = delete;
+
+    /// Destructor.
+    /// @note All blocks owned by the pools are returned to the heap.
+    ~SignalSafePool();
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because SignalSafePool is not meant to be copy-assigned.
+    SignalSafePool& operator=(const SignalSafePool&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because SignalSafePool is not meant to be move-assigned.
+    SignalSafePool& operator=(SignalSafePool&&) = delete;
+
+    /// Initializes the pools for all size classes up to the given size and fills them with blocks from the heap.
+    /// @param maxSize      Size of the biggest block, that can be allocated from the pools.
+    /// @param blocksCount  Number of blocks kept in the pool of each size class.
+    /// @return Flag indicating if the pools have been initialized.
+    /// @note Pools may not be filled completely if the heap runs out of memory. This is not treated as an error.
+    [[nodiscard]] bool init(std::size_t maxSize, std::size_t blocksCount);
+
+    /// Returns all blocks owned by the pools to the heap and deinitializes them.
+    /// @note All blocks allocated from the pools have to be released before this call.
+    void clear();
+
+    /// Allocates memory block with the given size from the pool of the matching size class.
+    /// @param size         Demanded size of the allocated memory block.
+    /// @return Result of the allocation.
+    /// @retval void*       Allocated memory block on success.
+    /// @retval nullptr     Pool is empty or the size is bigger than the one passed to init().
+    /// @note This function is async-signal-safe.
+    [[nodiscard]] void* allocate(std::size_t size);
+
+    /// Releases the memory block to the pool of the matching size class.
+    /// @param ptr          Memory block allocated from the pools.
+    /// @param size         Size, that was passed to allocate() for the given memory block.
+    /// @note This function is async-signal-safe. If the pool is full, block is returned to the heap by refill().
+    void release(void* ptr, std::size_t size);
+
+    /// Refills the pools with blocks from the heap and returns the surplus blocks to the heap.
+    /// @note This function has to be called from the normal context.
+    void refill();
+
+    /// Returns the number of blocks available in the pool for the given size.
+    /// @param size         Size of the memory block.
+    /// @return Number of blocks available in the matching pool.
+    [[nodiscard]] std::size_t availableCount(std::size_t size) const;
+
+private:
+    /// Represents the entry of the pool, that holds one block.
+    struct Slot {
+        std::atomic<std::uint32_t> next; ///< Index of the next slot in the same stack (0 means end of the stack).
+        void* block;                     ///< Block held by the slot, valid only when slot is in the ready stack.
+    };
+
+    /// Represents the pool of a single size class.
+    /// @note Stacks are indexed by 1-based slot indexes in the lower half of the head. Upper half is incremented by
+    ///       every update, which protects compare-and-swap against the ABA problem.
+    struct Pool {
+        Slot* slots;                      ///< Array of the slots of the pool.
+        std::atomic<std::uint32_t> ready; ///< Head of the stack of slots holding blocks.
+        std::atomic<std::uint32_t> empty; ///< Head of the stack of slots without blocks.
+        std::atomic<void*> overflow;      ///< List of blocks released, when the pool was full.
+        std::atomic<std::size_t> count;   ///< Number of slots holding blocks.
+    };
+
+    /// Pushes the given slot on the given stack.
+    /// @param head         Head of the stack.
+    /// @param slots        Array of the slots of the pool.
+    /// @param idx          1-based index of the pushed slot.
+    static void push(std::atomic<std::uint32_t>& head, Slot* slots, std::uint32_t idx);
+
+    /// Pops the slot from the given stack.
+    /// @param head         Head of the stack.
+    /// @param slots        Array of the slots of the pool.
+    /// @return 1-based index of the popped slot or 0 if the stack is empty.
+    static std::uint32_t pop(std::atomic<std::uint32_t>& head, Slot* slots);
+
+    /// Returns the pool for the given size.
+    /// @param size         Size of the memory block.
+    /// @return Pool for the given size or nullptr if the size is not supported.
+    Pool* findPool(std::size_t size);
+
+private:
+    static constexpr std::uint32_t m_cIndexMask = 0xffff;         ///< Mask of the slot index in the stack head.
+    static constexpr std::uint32_t m_cTagStep = m_cIndexMask + 1; ///< Increment of the tag in the stack head.
+
+    Heap* m_heap;                                          ///< Heap used as the source of the blocks.
+    std::size_t m_poolsCount{};                            ///< Number of initialized pools.
+    std::size_t m_blocksCount{};                           ///< Number of slots in each pool.
+    std::array<Pool, config::cSizeClassesCount> m_pools{}; ///< Pools of all size classes.
+};
+
+} // namespace memory
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MemoryResource.hpp"
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace memory {
+
+/// Represents the standard allocator, that allocates objects from the global heap.
+/// @note Size class of a single object is computed at compile time, so node-based containers allocating their nodes
+///       one by one go directly to the zones of that size class. Objects are always released with their size.
+template <typename T>
+class StlAllocator {
+public:
+    using value_type = T; ///< Type of the allocated objects.
+
+    /// Default constructor.
+    StlAllocator() noexcept = default;
+
+    /// Converting constructor.
+    /// @note It is used by the containers to rebind the allocator to their node type.
+    template <typename U>
+    StlAllocator(const StlAllocator<U>& /*unused*/) noexcept // NOLINT(google-explicit-constructor)
+    {}
+
+    /// Allocates memory for the given number of objects.
+    /// @param n            Number of objects to be allocated.
+    /// @return Allocated memory.
+    /// @note On failure std::bad_alloc is thrown or the program is terminated, when exceptions are disabled.
+    /// @note Allocation of 0 objects returns a unique pointer to the smallest chunk, just like operator new does.
+    /// @note Over-aligned types are allocated with allocator::allocateAligned(), because the size classes and pages
+    ///       guarantee only the alignment up to the page size.
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        void* ptr = nullptr;
+        if constexpr (m_cOverAligned) {
+            if (n <= std::numeric_limits<std::size_t>::max() / sizeof(T))
+                ptr = allocator::allocateAligned(std::max(n, std::size_t(1)) * sizeof(T), alignof(T));
+        }
+        else if (n == 1)
+            ptr = allocator::allocateSizeClass(m_cSizeClass);
+        else if (n == 0)
+            ptr = allocator::allocateSizeClass(0);
+        else if (n <= std::numeric_limits<std::size_t>::max() / sizeof(T))
+            ptr = allocator::allocate(n * sizeof(T));
+
+        if (ptr == nullptr) [[unlikely]]
+            detail::allocationFailed();
+
+        return static_cast<T*>(ptr);
+    }
+
+    /// Releases memory of the given number of objects.
+    /// @param ptr          Memory to be released.
+    /// @param n            Number of objects, that was passed to allocate().
+    void deallocate(T* ptr, std::size_t n)
+    {
+        if constexpr (m_cOverAligned)
+            allocator::release(ptr);
+        else if (n == 1)
+            allocator::releaseSizeClass(ptr, m_cSizeClass);
+        else if (n == 0)
+            allocator::releaseSizeClass(ptr, 0);
+        else
+            allocator::release(ptr, n * sizeof(T));
+    }
+
+private:
+    static constexpr std::size_t m_cSizeClass = allocator::sizeClass(sizeof(T)); ///< Size class of a single object.
+    static constexpr bool m_cOverAligned = alignof(T) > alignof(std::max_align_t); ///< Flag of the over-aligned type.
+};
+
+/// Checks if memory allocated by one allocator can be released by the other one.
+/// @return Always true, because all instances allocate from the global heap.
+template <typename T, typename U>
+bool operator==(const StlAllocator<T>& /*unused*/, const StlAllocator<U>& /*unused*/) noexcept
+{
+    return true;
+}
+
+} // namespace memory
@@ -32,8 +32,12 @@
 
 #pragma once
 
+#include "PageProvider.hpp"
 #include "Region.hpp"
+#include "config.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 
@@ -46,6 +50,20 @@ struct Stats {
     std::size_t userMemorySize;      ///< Size of the memory available to the user.
     std::size_t allocatedMemorySize; ///< Size of the memory allocated by the user.
     std::size_t freeMemorySize;      ///< Size of the free user memory.
+    std::size_t emergencySize;       ///< Size of the free memory kept as the emergency reserve.
+    std::size_t emergencyUsedSize;   ///< Size of the emergency reserve currently used by the critical allocations.
+};
+
+/// Represents the result of the allocation together with the real size of the allocated memory block.
+struct AllocationResult {
+    void* ptr;        ///< Allocated memory block or nullptr if some error occurred.
+    std::size_t size; ///< Real size of the allocated memory block. It is not less than the demanded size.
+};
+
+/// Represents the callback, that is asked to give memory back, when the free memory of the heap runs low.
+struct Shrinker {
+    std::size_t (*shrink)(std::size_t size, void* arg); ///< Releases memory of about the given size. Returns its size.
+    void* arg;                                          ///< User argument passed to the callback.
 };
 
 /// Returns version of liballocator.
@@ -55,22 +73,66 @@ const char* version();
 /// Initializes liballocator with the given array of memory regions and page size.
 /// @param regions      Array of memory regions to be used by liballocator. Last entry should be zeroed.
 /// @param pageSize     Size of the page on the current platform.
+/// @param zeroed       Flag indicating if the given regions are known to contain only zeros (e.g. fresh mmap).
 /// @return Result of the initialization.
 /// @retval true        Allocator has been initialized.
 /// @retval false       Some error occurred.
-[[nodiscard]] bool init(Region* regions, std::size_t pageSize);
+[[nodiscard]] bool init(Region* regions, std::size_t pageSize, bool zeroed = false);
 
 /// Initializes liballocator with the given array of memory boundaries and page size.
 /// @param start        Start address of a memory region to be used by liballocator.
 /// @param end          End address of a memory region to be used by liballocator.
 /// @param pageSize     Size of the page on the current platform.
+/// @param zeroed       Flag indicating if the given memory is known to contain only zeros (e.g. fresh mmap).
 /// @return Result of the initialization.
 /// @retval true        Allocator has been initialized.
 /// @retval false       Some error occurred.
 /// @note This overload is equivalent to the above version of init() with only one memory region entry.
-[[nodiscard]] bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize);
+[[nodiscard]] bool init(std::uintptr_t start, std::uintptr_t end, std::size_t pageSize, bool zeroed = false);
+
+/// Adds the given memory region to the already initialized liballocator.
+/// @param region       Memory region to be added.
+/// @param zeroed       Flag indicating if the given region is known to contain only zeros (e.g. fresh mmap).
+/// @return Result of the operation.
+/// @retval true        Region has been added.
+/// @retval false       Some error occurred.
+[[nodiscard]] bool addRegion(const Region& region, bool zeroed = false);
+
+/// Sets the page provider, that is asked for new regions, when liballocator runs out of free pages.
+/// @param provider         Page provider to be used or nullptr to disable growing. It has to outlive liballocator.
+/// @param directThreshold  Minimal size of the allocation, which is served from a dedicated region obtained from
+///                         the provider. Value 0 disables direct allocations.
+void setPageProvider(PageProvider* provider, std::size_t directThreshold = 0);
+
+/// Sets the size of the free memory, above which the free pages are decommitted through the page provider.
+/// @param threshold        Size of the free memory, that triggers decommit. Value 0 disables the automatic decommit.
+void setDecommitThreshold(std::size_t threshold);
+
+/// Gives the empty regions and the physical memory of all free pages back to the system through the page provider.
+/// @return Size of the memory, that has been given back.
+std::size_t trim();
+
+/// Sets the size of the emergency reserve, that only allocateCritical() can use.
+/// @param size             Size of the reserve. It is rounded up to the page size. Value 0 disables the reserve.
+void setEmergencyReserve(std::size_t size);
+
+/// Sets the watermarks of the free memory, that control reclaiming memory from the shrinkers.
+/// @param low              Size of the free memory, below which memory is reclaimed. Value 0 disables it.
+/// @param high             Size of the free memory, up to which memory is reclaimed.
+/// @note Memory is always reclaimed, before an allocation fails.
+void setWatermarks(std::size_t low, std::size_t high);
+
+/// Registers the given shrinker, that is asked to release memory, when the free memory runs low.
+/// @param shrinker         Shrinker to be registered.
+/// @return Flag indicating if the shrinker has been registered.
+[[nodiscard]] bool addShrinker(const Shrinker& shrinker);
+
+/// Unregisters the given shrinker.
+/// @param shrinker         Shrinker to be unregistered.
+void removeShrinker(const Shrinker& shrinker);
 
 /// Clears the internal state of liballocator.
+/// @note Regions obtained from the page provider are given back to it.
 void clear();
 
 /// Allocates memory block with the given size.
@@ -80,11 +142,108 @@ void clear();
 /// @retval nullptr     Some error occurred.
 [[nodiscard]] void* allocate(std::size_t size);
 
+/// Allocates memory block with at least the given size and returns its real size.
+/// @param size         Demanded size of the allocated memory block.
+/// @return Allocated memory block with its real size on success or {nullptr, 0} on failure.
+/// @note This is equivalent to C++23 allocate_at_least(). Whole returned size can be used by the caller.
+[[nodiscard]] AllocationResult allocateAtLeast(std::size_t size);
+
+/// Returns the size class, that serves the allocations of the given size.
+/// @param size         Demanded size of the memory block.
+/// @return Index of the size class.
+/// @note Size classes are powers of 2 starting from 16 bytes. This function can be evaluated at compile time.
+constexpr std::size_t sizeClass(std::size_t size)
+{
+    constexpr std::size_t cMinimalAllocSize = config::cMinimalAllocSize;
+    return std::bit_width(std::max(size, cMinimalAllocSize) - 1) - std::bit_width(cMinimalAllocSize - 1);
+}
+
+/// Allocates memory block from the given size class.
+/// @param sizeClass    Size class returned by sizeClass() for the demanded size.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note This version skips computation of the size class, so it is the fastest way to allocate objects of size known
+///       at compile time. Size classes not smaller than the page size are served directly with the pages.
+[[nodiscard]] void* allocateSizeClass(std::size_t sizeClass);
+
+/// Allocates memory block with the given size and fills it with zeros.
+/// @param size         Demanded size of the allocated memory block.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note Pages, that were never allocated from the allocator initialized with zeroed memory, are not cleared again.
+[[nodiscard]] void* allocateZeroed(std::size_t size);
+
+/// Allocates memory block with the given size, that can use the emergency reserve if there is no other free memory.
+/// @param size         Demanded size of the allocated memory block.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+[[nodiscard]] void* allocateCritical(std::size_t size);
+
+/// Allocates memory block with the given size and alignment.
+/// @param size         Demanded size of the allocated memory block.
+/// @param alignment    Demanded alignment of the allocated memory block. It must be a power of 2.
+/// @return Result of the allocation.
+/// @retval void*       Allocated memory block on success.
+/// @retval nullptr     Some error occurred.
+/// @note Allocated memory block can be released with any version of release().
+[[nodiscard]] void* allocateAligned(std::size_t size, std::size_t alignment);
+
+/// Allocates the given number of memory blocks with the given size.
+/// @param size         Demanded size of each allocated memory block.
+/// @param ptrs         Array, to which allocated memory blocks should be stored.
+/// @param count        Number of memory blocks to be allocated.
+/// @return Result of the allocation.
+/// @retval true        All memory blocks have been allocated.
+/// @retval false       Some error occurred. No memory block is allocated in that case.
+/// @note This is much cheaper than calling allocate() count times, because size class is computed only once.
+[[nodiscard]] bool allocateBatch(std::size_t size, void** ptrs, std::size_t count);
+
 /// Releases the memory block pointed by given pointer.
 /// @param ptr          Pointer to the memory block, that should be released.
 /// @note If the given pointer is nullptr, then function exists without an error.
 void release(void* ptr);
 
+/// Releases the memory block pointed by given pointer, that was allocated with the given size.
+/// @param ptr          Pointer to the memory block, that should be released.
+/// @param size         Size, that was passed to allocate() for the given memory block.
+/// @note If the given pointer is nullptr, then function exists without an error.
+/// @note This version is faster than release(void*), because the size class is computed directly from the given size.
+///       Passing different size than the one used in allocate() is checked with assertions in debug builds.
+void release(void* ptr, std::size_t size);
+
+/// Releases the memory block pointed by given pointer, that was allocated from the given size class.
+/// @param ptr          Pointer to the memory block, that should be released.
+/// @param sizeClass    Size class, that was passed to allocateSizeClass() for the given memory block.
+/// @note If the given pointer is nullptr, then function exists without an error.
+void releaseSizeClass(void* ptr, std::size_t sizeClass);
+
+/// Releases the given number of memory blocks.
+/// @param ptrs         Array of pointers to the memory blocks, that should be released.
+/// @param count        Number of memory blocks to be released.
+/// @note Array may contain nullptr entries. Blocks allocated together should be released together, so that the owner
+///       of the consecutive blocks is looked up only once.
+void releaseBatch(void** ptrs, std::size_t count);
+
+/// Changes the size of the memory block pointed by given pointer.
+/// @param ptr          Pointer to the memory block, that should be resized.
+/// @param size         Demanded size of the memory block.
+/// @return Result of the reallocation.
+/// @retval void*       Resized memory block on success. Its content is preserved up to the lesser of the sizes.
+/// @retval nullptr     Some error occurred. The given memory block is left untouched.
+/// @note If the given pointer is nullptr, then function is equivalent to allocate(size).
+/// @note If the given size is 0, then function is equivalent to release(ptr) and returns nullptr.
+/// @note Memory block is resized in place whenever possible, so no copying is needed.
+[[nodiscard]] void* reallocate(void* ptr, std::size_t size);
+
+/// Returns the real size of the memory block pointed by given pointer.
+/// @param ptr          Pointer to the memory block returned by one of the allocation functions.
+/// @return Size of the memory block, that can be used by the caller.
+/// @note This function works in constant time. It returns 0 for nullptr.
+std::size_t usableSize(void* ptr);
+
 /// Returns the current statistics of the allocator.
 /// @return liballocator statistics.
 Stats getStats();
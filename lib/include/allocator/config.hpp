@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+
+/// Size of the page fixed at compile time. Value 0 means, that page size is passed to init() at runtime.
+/// @note Fixed page size lets the compiler fold all masks, shifts and divisions by the page size and size the arrays
+///       of the zone allocator exactly. init() rejects any other page size in that case.
+#ifndef LIBALLOCATOR_PAGE_SIZE
+#define LIBALLOCATOR_PAGE_SIZE 0
+#endif
+
+/// Maximal number of memory regions supported by a single heap.
+#ifndef LIBALLOCATOR_MAX_REGIONS_COUNT
+#define LIBALLOCATOR_MAX_REGIONS_COUNT 8
+#endif
+
+/// Size of the CPU cache line. It is used to spread the objects of different zones across the cache sets.
+#ifndef LIBALLOCATOR_CACHE_LINE_SIZE
+#define LIBALLOCATOR_CACHE_LINE_SIZE 64
+#endif
+
+namespace memory::config {
+
+/// Size of the page fixed at compile time or 0 if it is given at runtime.
+constexpr std::size_t cPageSize = LIBALLOCATOR_PAGE_SIZE;
+
+/// Maximal number of memory regions supported by a single heap.
+constexpr std::size_t cMaxRegionsCount = LIBALLOCATOR_MAX_REGIONS_COUNT;
+
+/// Size of the CPU cache line.
+constexpr std::size_t cCacheLineSize = LIBALLOCATOR_CACHE_LINE_SIZE;
+
+/// Size of the smallest size class.
+constexpr std::size_t cMinimalAllocSize = 16;
+
+/// Number of size classes served by zones. Size classes not smaller than the page are served directly with pages.
+/// @note For the runtime page size the array is sized for the pages up to 4096 bytes.
+constexpr std::size_t cSizeClassesCount = std::bit_width((cPageSize != 0) ? cPageSize : 4096) // NOLINT
+                                        - std::bit_width(cMinimalAllocSize);
+
+static_assert(cPageSize == 0 || std::has_single_bit(cPageSize), "page size must be a power of 2");
+static_assert(cMaxRegionsCount > 0, "at least one memory region has to be supported");
+static_assert(std::has_single_bit(cCacheLineSize), "cache line size must be a power of 2");
+
+/// Returns the page size, that should be used.
+/// @param runtimePageSize  Page size given at runtime.
+/// @return Page size fixed at compile time if present, otherwise the given page size.
+constexpr std::size_t pageSize(std::size_t runtimePageSize)
+{
+    return (cPageSize != 0) ? cPageSize : runtimePageSize;
+}
+
+} // namespace memory::config
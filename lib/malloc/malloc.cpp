@@ -0,0 +1,311 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+#include <allocator/Heap.hpp>
+#include <allocator/MmapPageProvider.hpp>
+#include <allocator/config.hpp>
+
+#include <malloc.h>
+#include <pthread.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/// Default size of the initial mapping of the heap, when LIBALLOCATOR_HEAP_SIZE is not set in environment.
+#ifndef LIBALLOCATOR_MALLOC_HEAP_SIZE
+#define LIBALLOCATOR_MALLOC_HEAP_SIZE (64ULL << 20) // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+
+/// Default size of the free memory, that triggers decommit, when LIBALLOCATOR_DECOMMIT_THRESHOLD is not set.
+#ifndef LIBALLOCATOR_MALLOC_DECOMMIT_THRESHOLD
+#define LIBALLOCATOR_MALLOC_DECOMMIT_THRESHOLD (64ULL << 20) // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+
+namespace {
+
+constexpr std::size_t cPageSize = memory::config::pageSize(4096);
+constexpr std::size_t cDefaultHeapSize = LIBALLOCATOR_MALLOC_HEAP_SIZE;
+constexpr std::size_t cDefaultDecommitThreshold = LIBALLOCATOR_MALLOC_DECOMMIT_THRESHOLD;
+
+// Heap is constructed on the first allocation, because malloc() can be called before any static constructor.
+// Neither the heap nor the provider is ever destroyed, because malloc() can also be called after static destructors.
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays)
+alignas(memory::Heap) std::byte heapStorage[sizeof(memory::Heap)];
+alignas(memory::MmapPageProvider) std::byte providerStorage[sizeof(memory::MmapPageProvider)];
+memory::Heap* heap = nullptr;
+bool heapFailed = false;
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables,cppcoreguidelines-avoid-c-arrays)
+
+/// Holds the global allocator lock for the lifetime of the object.
+class Lock {
+public:
+    Lock() { pthread_mutex_lock(&mutex); }
+    Lock(const Lock&) = delete;
+    Lock(Lock&&) = delete;
+    ~Lock() { pthread_mutex_unlock(&mutex); }
+    Lock& operator=(const Lock&) = delete;
+    Lock& operator=(Lock&&) = delete;
+};
+
+/// Returns the size given in the environment variable with the given name.
+/// @param name         Name of the environment variable.
+/// @param defaultSize  Size returned, when the variable is not set or cannot be parsed.
+/// @return Size given in the environment or the default one.
+/// @note Environment is read with getenv() and strtoull(), because neither of them allocates memory.
+std::size_t envSize(const char* name, std::size_t defaultSize)
+{
+    if (const char* value = std::getenv(name)) {
+        char* end = nullptr;
+        if (auto parsed = std::strtoull(value, &end, 0); end != value)
+            return parsed;
+    }
+
+    return defaultSize;
+}
+
+/// Returns the size of the initial mapping of the heap.
+/// @return Size of the initial mapping rounded up to the page size.
+/// @note Descriptors of all its pages are written on the first allocation, so it is kept small and the heap grows
+///       through the page provider instead.
+std::size_t heapSize()
+{
+    std::size_t size = envSize("LIBALLOCATOR_HEAP_SIZE", cDefaultHeapSize);
+    if (size == 0)
+        size = cDefaultHeapSize;
+
+    return (size + cPageSize - 1) & ~(cPageSize - 1);
+}
+
+/// Returns the heap, initializing it on the first use. It must be called with the lock held.
+/// @return Result of the operation.
+/// @retval Heap*       Initialized heap.
+/// @retval nullptr     Memory for the heap could not be reserved.
+memory::Heap* getHeap()
+{
+    if (heap != nullptr || heapFailed) [[likely]]
+        return heap;
+
+    // Huge pages are opt-in, because they increase the resident size of the sparsely used heaps.
+    bool hugePages = (envSize("LIBALLOCATOR_HUGE_PAGES", 0) != 0);
+    auto* provider = new (providerStorage) memory::MmapPageProvider(false, hugePages);
+    auto region = provider->allocate(heapSize());
+    if (region.size == 0) {
+        heapFailed = true;
+        return nullptr;
+    }
+
+    // Fresh anonymous mapping contains only zeros, so calloc() does not have to clear it again.
+    auto* newHeap = new (heapStorage) memory::Heap();
+    if (!newHeap->init(region.address, region.address + region.size, cPageSize, true)) {
+        provider->release(region);
+        heapFailed = true;
+        return nullptr;
+    }
+
+    // Heap grows with further mappings, when the initial one is exhausted. Free pages are given back with madvise().
+    // Direct mappings are opt-in, because each of them takes one of the few region slots of the heap.
+    newHeap->setPageProvider(provider, envSize("LIBALLOCATOR_DIRECT_THRESHOLD", 0));
+    newHeap->setDecommitThreshold(envSize("LIBALLOCATOR_DECOMMIT_THRESHOLD", cDefaultDecommitThreshold));
+    heap = newHeap;
+    return heap;
+}
+
+/// Allocates memory block with the given size and alignment from the heap.
+/// @param size         Demanded size of the allocated memory block.
+/// @param alignment    Demanded alignment of the allocated memory block. Value 0 means the default alignment.
+/// @return Allocated memory block or nullptr with errno set to ENOMEM.
+void* allocate(std::size_t size, std::size_t alignment = 0)
+{
+    // Zero-sized allocations must return unique pointers.
+    if (size == 0)
+        size = 1;
+
+    void* ptr = nullptr;
+    {
+        Lock lock;
+        if (auto* instance = getHeap())
+            ptr = (alignment == 0) ? instance->allocate(size) : instance->allocateAligned(size, alignment);
+    }
+
+    if (ptr == nullptr)
+        errno = ENOMEM;
+
+    return ptr;
+}
+
+/// Checks if the given alignment can be served by the heap.
+/// @param alignment    Alignment to be checked.
+/// @return Flag indicating if the given alignment is valid.
+constexpr bool isValidAlignment(std::size_t alignment)
+{
+    return (alignment != 0 && (alignment & (alignment - 1)) == 0);
+}
+
+void forkPrepare()
+{
+    pthread_mutex_lock(&mutex);
+}
+
+void forkRelease()
+{
+    pthread_mutex_unlock(&mutex);
+}
+
+/// Makes sure, that the heap is not forked in the middle of an operation, done by another thread.
+/// @note Handlers are registered from the library constructor, because pthread_atfork() may allocate memory.
+[[gnu::constructor]] void registerForkHandlers()
+{
+    pthread_atfork(forkPrepare, forkRelease, forkRelease);
+}
+
+} // namespace
+
+// NOLINTBEGIN(readability-inconsistent-declaration-parameter-name)
+extern "C" {
+
+void* malloc(std::size_t size) noexcept
+{
+    return allocate(size);
+}
+
+void free(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    // Block released before the first allocation cannot come from the heap, so it is ignored.
+    Lock lock;
+    if (heap != nullptr)
+        heap->release(ptr);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    std::size_t totalSize = 0;
+    if (__builtin_mul_overflow(count, size, &totalSize)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    if (totalSize == 0)
+        totalSize = 1;
+
+    void* ptr = nullptr;
+    {
+        Lock lock;
+        if (auto* instance = getHeap())
+            ptr = instance->allocateZeroed(totalSize);
+    }
+
+    if (ptr == nullptr)
+        errno = ENOMEM;
+
+    return ptr;
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    if (ptr == nullptr)
+        return allocate(size);
+
+    void* newPtr = nullptr;
+    {
+        // Size 0 releases the memory block, just like in glibc.
+        Lock lock;
+        if (heap != nullptr)
+            newPtr = heap->reallocate(ptr, size);
+    }
+
+    if (newPtr == nullptr && size != 0)
+        errno = ENOMEM;
+
+    return newPtr;
+}
+
+int posix_memalign(void** memptr, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || !isValidAlignment(alignment))
+        return EINVAL;
+
+    auto* ptr = allocate(size, alignment);
+    if (ptr == nullptr)
+        return ENOMEM;
+
+    *memptr = ptr;
+    return 0;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    if (!isValidAlignment(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    return allocate(size, alignment);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    return aligned_alloc(alignment, size);
+}
+
+void* valloc(std::size_t size) noexcept
+{
+    return allocate(size, cPageSize);
+}
+
+void* pvalloc(std::size_t size) noexcept
+{
+    return allocate((size + cPageSize - 1) & ~(cPageSize - 1), cPageSize);
+}
+
+int malloc_trim([[maybe_unused]] std::size_t pad) noexcept
+{
+    Lock lock;
+    return (heap != nullptr && heap->trim() != 0) ? 1 : 0;
+}
+
+std::size_t malloc_usable_size(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return 0;
+
+    Lock lock;
+    return (heap != nullptr) ? heap->usableSize(ptr) : 0;
+}
+
+} // extern "C"
+// NOLINTEND(readability-inconsistent-declaration-parameter-name)
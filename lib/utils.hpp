@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include <bit>
 #include <cstddef>
 
 namespace memory::utils {
@@ -41,7 +42,7 @@ namespace memory::utils {
 /// @return Flag indicating if the given value is a power of 2.
 /// @retval true        Value is power of 2.
 /// @retval false       Value is not a power of 2.
-inline bool isPowerOf2(std::size_t value)
+constexpr bool isPowerOf2(std::size_t value)
 {
     return (value > 0 && ((value & (value - 1)) == 0));
 }
@@ -49,7 +50,7 @@ inline bool isPowerOf2(std::size_t value)
 /// Returns the given value, that is rounded up to the closest power of 2.
 /// @param value        Value to be rounded.
 /// @return Value rounded up to the closest power of 2.
-inline std::size_t roundPowerOf2(std::size_t value)
+constexpr std::size_t roundPowerOf2(std::size_t value)
 {
     auto result = value;
 
@@ -64,6 +65,42 @@ inline std::size_t roundPowerOf2(std::size_t value)
     return result;
 }
 
+/// Returns the given value, that is rounded up to the closest multiple of the given alignment.
+/// @param value        Value to be rounded.
+/// @param alignment    Alignment to be used. It must be a power of 2.
+/// @return Value rounded up to the closest multiple of the alignment.
+constexpr std::size_t roundUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/// Returns the given value, that is rounded down to the closest multiple of the given alignment.
+/// @param value        Value to be rounded.
+/// @param alignment    Alignment to be used. It must be a power of 2.
+/// @return Value rounded down to the closest multiple of the alignment.
+constexpr std::size_t roundDown(std::size_t value, std::size_t alignment)
+{
+    return value & ~(alignment - 1);
+}
+
+/// Returns the integer part of the base 2 logarithm of the given value.
+/// @param value        Value to be used. It must be greater than 0.
+/// @return Integer part of the base 2 logarithm of the value.
+/// @note This is computed with the count of leading zeros, so no floating-point operations are involved.
+constexpr std::size_t log2(std::size_t value)
+{
+    return std::bit_width(value) - 1;
+}
+
+/// Returns the result of the division, that is rounded up to the closest integer.
+/// @param value        Value to be divided.
+/// @param divisor      Divisor to be used. It must be greater than 0.
+/// @return Result of the division rounded up.
+constexpr std::size_t divRoundUp(std::size_t value, std::size_t divisor)
+{
+    return (value / divisor) + ((value % divisor != 0) ? 1 : 0);
+}
+
 /// Returns the given pointer moved by given number of bytes.
 /// @param ptr          Pointer to be moved.
 /// @param step         Number of bytes to move the pointer.
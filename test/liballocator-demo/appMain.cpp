@@ -57,9 +57,9 @@ void operator delete(void* ptr) noexcept
     memory::allocator::release(ptr);
 }
 
-void operator delete(void* ptr, [[maybe_unused]] std::size_t sz) noexcept
+void operator delete(void* ptr, std::size_t sz) noexcept
 {
-    operator delete(ptr);
+    memory::allocator::release(ptr, sz);
 }
 
 static std::size_t freeMemory()
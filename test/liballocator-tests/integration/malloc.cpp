@@ -0,0 +1,188 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace memory {
+namespace {
+
+/// Biggest size, that can be passed to the allocation functions. It is volatile, so that the compiler cannot reject it.
+volatile std::size_t maxSize = std::numeric_limits<std::size_t>::max(); // NOLINT
+
+} // namespace
+
+// This test is run only in the child process started below, whose allocation functions come from liballocator-malloc.
+TEST_CASE("Allocation functions are replaced by liballocator-malloc", "[.][malloc-preload]")
+{
+    Dl_info info{};
+    REQUIRE(dladdr(dlsym(RTLD_DEFAULT, "malloc"), &info) != 0);
+    REQUIRE(std::strstr(info.dli_fname, "allocator-malloc") != nullptr);
+
+    SECTION("malloc")
+    {
+        auto* ptr1 = std::malloc(0);
+        auto* ptr2 = std::malloc(0);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(ptr1 != ptr2);
+        std::free(ptr1);
+        std::free(ptr2);
+
+        constexpr std::size_t cAllocSize = 100;
+        auto* ptr = std::malloc(cAllocSize);
+        REQUIRE(ptr);
+        REQUIRE(malloc_usable_size(ptr) >= cAllocSize);
+        std::free(ptr);
+
+        errno = 0;
+        REQUIRE(std::malloc(maxSize) == nullptr);
+        REQUIRE(errno == ENOMEM);
+    }
+
+    SECTION("calloc")
+    {
+        constexpr std::size_t cCount = 1000;
+        auto* ptr = static_cast<unsigned char*>(std::calloc(cCount, sizeof(int)));
+        REQUIRE(ptr);
+        for (std::size_t i = 0; i < cCount * sizeof(int); ++i)
+            REQUIRE(ptr[i] == 0);
+
+        std::free(ptr);
+
+        errno = 0;
+        REQUIRE(std::calloc(maxSize / 2, 4) == nullptr);
+        REQUIRE(errno == ENOMEM);
+    }
+
+    SECTION("realloc")
+    {
+        constexpr int cPattern = 0x5a;
+        constexpr std::size_t cAllocSize = 64;
+        auto* ptr = static_cast<unsigned char*>(std::realloc(nullptr, cAllocSize));
+        REQUIRE(ptr);
+        std::memset(ptr, cPattern, cAllocSize);
+
+        ptr = static_cast<unsigned char*>(std::realloc(ptr, 64 * cAllocSize));
+        REQUIRE(ptr);
+        REQUIRE(ptr[0] == cPattern);
+        REQUIRE(ptr[cAllocSize - 1] == cPattern);
+
+        REQUIRE(std::realloc(ptr, 0) == nullptr);
+    }
+
+    SECTION("posix_memalign")
+    {
+        constexpr std::array<std::size_t, 5> cAlignments = {sizeof(void*), 64, 4096, 8192, 2 * 1024 * 1024};
+        for (auto alignment : cAlignments) {
+            void* ptr = nullptr;
+            REQUIRE(posix_memalign(&ptr, alignment, 100) == 0);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+            std::free(ptr);
+
+            ptr = aligned_alloc(alignment, alignment);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+            std::free(ptr);
+        }
+
+        void* ptr = nullptr;
+        REQUIRE(posix_memalign(&ptr, 0, 100) == EINVAL);
+        REQUIRE(posix_memalign(&ptr, 3 * sizeof(void*), 100) == EINVAL);
+        REQUIRE(posix_memalign(&ptr, sizeof(void*) / 2, 100) == EINVAL);
+    }
+
+    SECTION("fork")
+    {
+        constexpr std::size_t cAllocSize = 1000;
+        auto* ptr = std::malloc(cAllocSize);
+        REQUIRE(ptr);
+
+        auto pid = fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            auto* childPtr = std::malloc(cAllocSize);
+            std::free(ptr);
+            std::free(childPtr);
+            _exit(childPtr != nullptr ? 0 : 1);
+        }
+
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+        std::free(ptr);
+    }
+}
+
+#ifdef LIBALLOCATOR_MALLOC_PATH
+TEST_CASE("liballocator-malloc can replace allocation functions of a binary", "[integration][malloc]")
+{
+    std::array<char, PATH_MAX> path{};
+    auto length = readlink("/proc/self/exe", path.data(), path.size() - 1);
+    REQUIRE(length > 0);
+
+    // Test binary is started again with the library preloaded and it runs only the test case above.
+    auto pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        setenv("LD_PRELOAD", LIBALLOCATOR_MALLOC_PATH, 1);
+        std::array<char*, 3> argv{path.data(), const_cast<char*>("[malloc-preload]"), nullptr};
+        execv(path.data(), argv.data());
+        _exit(EXIT_FAILURE);
+    }
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+}
+#endif
+
+} // namespace memory
+
+#endif
@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+
+struct ResourcePerfStats {
+    double heapFill = 0.0;
+    double heapDestroy = 0.0;
+    double arenaFill = 0.0;
+    double arenaDestroy = 0.0;
+    double newDeleteFill = 0.0;
+    double newDeleteDestroy = 0.0;
+};
+
+static void perfShowStats(const ResourcePerfStats& stats, const char* name, bool showFirst = false)
+{
+    if (showFirst)
+        std::printf("+--------------------------------+-------------+-------------+\n"); // NOLINT
+    std::printf("| %-30s |    fill     |   destroy   |\n", name);                        // NOLINT
+    std::printf("+--------------------------------+-------------+-------------+\n");     // NOLINT
+    std::printf("| %30s | %8.1f us | %8.1f us |\n", "HeapResource", stats.heapFill, stats.heapDestroy); // NOLINT
+    std::printf("| %30s | %8.1f us | %8.1f us |\n", "ArenaResource", stats.arenaFill, stats.arenaDestroy); // NOLINT
+    // NOLINTNEXTLINE
+    std::printf("| %30s | %8.1f us | %8.1f us |\n", "new_delete_resource", stats.newDeleteFill, stats.newDeleteDestroy);
+    std::printf("+--------------------------------+-------------+-------------+\n"); // NOLINT
+}
+
+/// Measures the time of filling the container created with the given resource and the time of its destruction.
+template <typename Container, typename Fill>
+static void perfMeasure(std::pmr::memory_resource* resource, Fill fill, double& fillTime, double& destroyTime)
+{
+    auto* container = new Container(resource); // NOLINT(cppcoreguidelines-owning-memory)
+
+    auto startFill = test::currentTime();
+    fill(*container);
+    auto endFill = test::currentTime();
+
+    auto startDestroy = test::currentTime();
+    delete container; // NOLINT(cppcoreguidelines-owning-memory)
+    auto endDestroy = test::currentTime();
+
+    fillTime += test::toMicroseconds(endFill - startFill);
+    destroyTime += test::toMicroseconds(endDestroy - startDestroy);
+}
+
+namespace memory {
+
+/// Runs the given container benchmark against all memory resources.
+template <typename Container, typename Fill>
+static void perfRun(const char* name, Fill fill, bool showFirst = false)
+{
+    constexpr int cIterationsCount = 100;
+    ResourcePerfStats stats{};
+
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 4096;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(memory != nullptr);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    HeapResource heapResource(heap);
+
+    constexpr std::size_t cBlockSize = 16 * cPageSize;
+    Arena arena(heap, cBlockSize);
+    ArenaResource arenaResource(arena);
+
+    for (int i = 0; i < cIterationsCount; ++i) {
+        perfMeasure<Container>(&heapResource, fill, stats.heapFill, stats.heapDestroy);
+        perfMeasure<Container>(&arenaResource, fill, stats.arenaFill, stats.arenaDestroy);
+        arena.reset();
+        perfMeasure<Container>(std::pmr::new_delete_resource(), fill, stats.newDeleteFill, stats.newDeleteDestroy);
+    }
+
+    stats.heapFill /= double(cIterationsCount);
+    stats.heapDestroy /= double(cIterationsCount);
+    stats.arenaFill /= double(cIterationsCount);
+    stats.arenaDestroy /= double(cIterationsCount);
+    stats.newDeleteFill /= double(cIterationsCount);
+    stats.newDeleteDestroy /= double(cIterationsCount);
+    perfShowStats(stats, name, showFirst);
+}
+
+TEST_CASE("std::pmr::list with 10000 elements", "[perf][MemoryResource]")
+{
+    constexpr int cElementsCount = 10000;
+    perfRun<std::pmr::list<int>>(
+        "pmr::list<int> 10000x",
+        [](auto& list) {
+            for (int i = 0; i < cElementsCount; ++i)
+                list.push_back(i);
+        },
+        true);
+}
+
+TEST_CASE("std::pmr::map with 10000 elements", "[perf][MemoryResource]")
+{
+    constexpr int cElementsCount = 10000;
+    perfRun<std::pmr::map<int, int>>("pmr::map<int, int> 10000x", [](auto& map) {
+        for (int i = 0; i < cElementsCount; ++i)
+            map.emplace(i, i);
+    });
+}
+
+TEST_CASE("std::pmr::list with 1000 strings", "[perf][MemoryResource]")
+{
+    constexpr int cElementsCount = 1000;
+    perfRun<std::pmr::list<std::pmr::string>>("pmr::list<pmr::string> 1000x", [](auto& list) {
+        for (int i = 0; i < cElementsCount; ++i)
+            list.emplace_back("string that is long enough to not fit into the small buffer");
+    });
+}
+
+} // namespace memory
@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+#include <Cache.hpp>
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/ObjectCache.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/// Touches the first word of each given object the given number of times.
+/// @return Time of the iteration in microseconds.
+static double perfIterate(const std::vector<void*>& objects, int iterationsCount)
+{
+    volatile std::uintptr_t sink = 0;
+
+    auto start = test::currentTime();
+    for (int i = 0; i < iterationsCount; ++i) {
+        std::uintptr_t sum = 0;
+        for (auto* object : objects)
+            sum += *static_cast<std::uintptr_t*>(object);
+
+        sink = sink + sum;
+    }
+    auto end = test::currentTime();
+
+    return test::toMicroseconds(end - start) / double(iterationsCount);
+}
+
+namespace memory {
+
+TEST_CASE("Iterating objects from 1024 zones", "[perf][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 4096;
+    constexpr std::size_t cObjectSize = 700;
+    constexpr std::size_t cZonesCount = 1024;
+    constexpr int cIterationsCount = 200;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(memory != nullptr);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    auto* cache = heap.cacheCreate("perf", cObjectSize, alignof(std::uintptr_t), {});
+    REQUIRE(cache);
+    auto objectsPerZone = cache->objectsPerZone();
+
+    // Colored objects are taken from the cache.
+    std::vector<void*> colored;
+    for (std::size_t i = 0; i < cZonesCount * objectsPerZone; ++i) {
+        auto* object = cacheAllocate(cache);
+        REQUIRE(object);
+        *static_cast<std::uintptr_t*>(object) = i;
+        colored.push_back(object);
+    }
+
+    // Uncolored objects are laid out the same way, but always from the beginning of the page.
+    std::vector<void*> pages;
+    std::vector<void*> uncolored;
+    for (std::size_t i = 0; i < cZonesCount; ++i) {
+        auto* page = heap.allocate(cPageSize);
+        REQUIRE(page);
+        pages.push_back(page);
+
+        for (std::size_t j = 0; j < objectsPerZone; ++j) {
+            auto* object = static_cast<std::byte*>(page) + (objectsPerZone - j - 1) * cObjectSize;
+            *reinterpret_cast<std::uintptr_t*>(object) = i * objectsPerZone + j;
+            uncolored.push_back(object);
+        }
+    }
+
+    // Warm up both sets of objects.
+    perfIterate(colored, 1);
+    perfIterate(uncolored, 1);
+
+    auto uncoloredTime = perfIterate(uncolored, cIterationsCount);
+    auto coloredTime = perfIterate(colored, cIterationsCount);
+
+    std::printf("+--------------------------------+-------------+\n");  // NOLINT
+    std::printf("| %-30s |   iterate   |\n", "1024 zones x 5 objects"); // NOLINT
+    std::printf("+--------------------------------+-------------+\n");  // NOLINT
+    std::printf("| %30s | %8.1f us |\n", "uncolored", uncoloredTime);   // NOLINT
+    std::printf("| %30s | %8.1f us |\n", "colored", coloredTime);       // NOLINT
+    std::printf("+--------------------------------+-------------+\n");  // NOLINT
+
+    for (auto* object : colored)
+        cacheRelease(cache, object);
+
+    for (auto* page : pages)
+        heap.release(page);
+
+    cacheDestroy(cache);
+}
+
+} // namespace memory
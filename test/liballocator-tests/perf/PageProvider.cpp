@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MmapPageProvider.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/// Represents the hardware counter of the data TLB misses of the current thread.
+/// @note Counter is not available on all machines (e.g. in virtual machines), which is reported by isValid().
+class TlbMissCounter {
+public:
+    /// Constructor. Opens the counter of the current thread in the disabled state.
+    TlbMissCounter()
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8U) // NOLINT
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);                     // NOLINT
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    /// Copy constructor.
+    /// @note This constructor is deleted, because counter owns the file descriptor.
+    TlbMissCounter(const TlbMissCounter&) = delete;
+
+    /// Move constructor.
+    /// @note This constructor is deleted, because counter owns the file descriptor.
+    TlbMissCounter(TlbMissCounter&&) = delete;
+
+    /// Destructor. Closes the counter.
+    ~TlbMissCounter()
+    {
+        if (isValid())
+            close(m_fd);
+    }
+
+    /// Copy assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because counter owns the file descriptor.
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+    /// Move assignment operator.
+    /// @return Reference to self.
+    /// @note This operator is deleted, because counter owns the file descriptor.
+    TlbMissCounter& operator=(TlbMissCounter&&) = delete;
+
+    /// Checks, if the counter has been opened.
+    /// @return Flag indicating if the counter is available on this machine.
+    [[nodiscard]] bool isValid() const { return m_fd >= 0; }
+
+    /// Resets the counter and starts counting.
+    void start()
+    {
+        if (!isValid())
+            return;
+
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    }
+
+    /// Stops counting.
+    /// @return Number of the data TLB misses since the last start() or 0 if the counter is not available.
+    std::uint64_t stop()
+    {
+        if (!isValid())
+            return 0;
+
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        std::uint64_t count = 0;
+        if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+            return 0;
+
+        return count;
+    }
+
+private:
+    int m_fd; ///< File descriptor of the counter or -1 if it could not be opened.
+};
+
+/// Represents the result of the single walk over the objects.
+struct WalkResult {
+    double time;          ///< Time of the walk in microseconds.
+    std::uint64_t misses; ///< Number of the data TLB misses during the walk.
+};
+
+/// Allocates the objects from the heap backed by the given provider and walks over them in the random order.
+/// @param provider         Provider of the heap memory.
+/// @param heapSize         Size of the heap.
+/// @param objectSize       Size of each object.
+/// @param objectsCount     Number of objects to be allocated.
+/// @param counter          Counter of the data TLB misses.
+/// @return Time and number of the data TLB misses of the walk.
+static WalkResult perfWalk(memory::MmapPageProvider& provider,
+                           std::size_t heapSize,
+                           std::size_t objectSize,
+                           std::size_t objectsCount,
+                           TlbMissCounter& counter)
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr unsigned int cSeed = 42;
+    constexpr int cIterationsCount = 4;
+
+    auto region = provider.allocate(heapSize);
+    REQUIRE(region.size != 0);
+
+    memory::Heap heap;
+    REQUIRE(heap.init(region.address, region.address + region.size, cPageSize, true));
+
+    std::vector<void*> objects;
+    for (std::size_t i = 0; i < objectsCount; ++i) {
+        objects.push_back(heap.allocate(objectSize));
+        REQUIRE(objects.back());
+        *static_cast<std::uintptr_t*>(objects.back()) = i;
+    }
+
+    // Objects are visited in the random order, so that almost every access hits a different page.
+    std::vector<void*> order(objects);
+    std::shuffle(order.begin(), order.end(), std::mt19937(cSeed));
+
+    volatile std::uintptr_t sink = 0;
+    counter.start();
+    auto start = test::currentTime();
+    for (int i = 0; i < cIterationsCount; ++i) {
+        std::uintptr_t sum = 0;
+        for (auto* object : order)
+            sum += *static_cast<std::uintptr_t*>(object);
+
+        sink = sink + sum;
+    }
+    auto end = test::currentTime();
+    auto misses = counter.stop();
+
+    for (auto* object : objects)
+        heap.release(object);
+
+    heap.clear();
+    provider.release(region);
+    return {test::toMicroseconds(end - start) / cIterationsCount, misses / cIterationsCount};
+}
+
+namespace memory {
+
+TEST_CASE("Walking objects from the heap backed by huge pages", "[perf][PageProvider]")
+{
+    constexpr std::size_t cHeapSize = 256 * 1024 * 1024;
+    constexpr std::size_t cObjectSize = 256;
+    constexpr std::size_t cObjectsCount = 512 * 1024;
+
+    TlbMissCounter counter;
+    MmapPageProvider regularProvider;
+    MmapPageProvider hugeProvider(false, true);
+
+    // Warm up the code paths and the page tables of the process.
+    perfWalk(regularProvider, cHeapSize, cObjectSize, cObjectsCount / 8, counter);
+
+    auto regular = perfWalk(regularProvider, cHeapSize, cObjectSize, cObjectsCount, counter);
+    auto huge = perfWalk(hugeProvider, cHeapSize, cObjectSize, cObjectsCount, counter);
+
+    std::printf("+--------------------------------+-------------+-----------------+\n"); // NOLINT
+    std::printf("| %-30s |    walk     |   dTLB misses   |\n", "512K objects x 256 B");  // NOLINT
+    std::printf("+--------------------------------+-------------+-----------------+\n"); // NOLINT
+    for (const auto& [name, result] : {std::pair{"4 KiB pages", regular}, std::pair{"huge pages", huge}}) {
+        auto misses = static_cast<unsigned long long>(result.misses); // NOLINT(google-runtime-int)
+        if (counter.isValid())
+            std::printf("| %30s | %8.1f us | %15llu |\n", name, result.time, misses); // NOLINT
+        else
+            std::printf("| %30s | %8.1f us | %15s |\n", name, result.time, "n/a"); // NOLINT
+    }
+    std::printf("+--------------------------------+-------------+-----------------+\n"); // NOLINT
+}
+
+} // namespace memory
+#endif
@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/StlAllocator.hpp>
+#include <allocator/allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+struct StlPerfStats {
+    double liballocatorFill = 0.0;
+    double liballocatorDestroy = 0.0;
+    double stdFill = 0.0;
+    double stdDestroy = 0.0;
+};
+
+static void perfShowStats(const StlPerfStats& stats, const char* name, bool showFirst = false)
+{
+    if (showFirst)
+        std::printf("+--------------------------------+-------------+-------------+\n"); // NOLINT
+    std::printf("| %-30s |    fill     |   destroy   |\n", name);                        // NOLINT
+    std::printf("+--------------------------------+-------------+-------------+\n");     // NOLINT
+    // NOLINTNEXTLINE
+    std::printf("| %30s | %8.1f us | %8.1f us |\n", "StlAllocator", stats.liballocatorFill, stats.liballocatorDestroy);
+    std::printf("| %30s | %8.1f us | %8.1f us |\n", "std::allocator", stats.stdFill, stats.stdDestroy); // NOLINT
+    std::printf("+--------------------------------+-------------+-------------+\n");                   // NOLINT
+}
+
+/// Measures the time of filling the given container type and the time of its destruction.
+template <typename Container, typename Fill>
+static void perfMeasure(Fill fill, double& fillTime, double& destroyTime)
+{
+    auto* container = new Container(); // NOLINT(cppcoreguidelines-owning-memory)
+
+    auto startFill = test::currentTime();
+    fill(*container);
+    auto endFill = test::currentTime();
+
+    auto startDestroy = test::currentTime();
+    delete container; // NOLINT(cppcoreguidelines-owning-memory)
+    auto endDestroy = test::currentTime();
+
+    fillTime += test::toMicroseconds(endFill - startFill);
+    destroyTime += test::toMicroseconds(endDestroy - startDestroy);
+}
+
+namespace memory {
+
+/// Runs the given container benchmark with StlAllocator and std::allocator.
+template <typename StlContainer, typename StdContainer, typename Fill>
+static void perfRun(const char* name, Fill fill, bool showFirst = false)
+{
+    constexpr int cIterationsCount = 100;
+    StlPerfStats stats{};
+
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 4096;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(memory != nullptr);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    for (int i = 0; i < cIterationsCount; ++i) {
+        perfMeasure<StlContainer>(fill, stats.liballocatorFill, stats.liballocatorDestroy);
+        perfMeasure<StdContainer>(fill, stats.stdFill, stats.stdDestroy);
+    }
+
+    allocator::clear();
+
+    stats.liballocatorFill /= double(cIterationsCount);
+    stats.liballocatorDestroy /= double(cIterationsCount);
+    stats.stdFill /= double(cIterationsCount);
+    stats.stdDestroy /= double(cIterationsCount);
+    perfShowStats(stats, name, showFirst);
+}
+
+using IntPair = std::pair<const int, int>;
+
+TEST_CASE("std::list with 10000 elements", "[perf][StlAllocator]")
+{
+    constexpr int cElementsCount = 10000;
+    perfRun<std::list<int, StlAllocator<int>>, std::list<int>>(
+        "list<int> 10000x",
+        [](auto& list) {
+            for (int i = 0; i < cElementsCount; ++i)
+                list.push_back(i);
+        },
+        true);
+}
+
+TEST_CASE("std::map with 10000 elements", "[perf][StlAllocator]")
+{
+    constexpr int cElementsCount = 10000;
+    using StlMap = std::map<int, int, std::less<>, StlAllocator<IntPair>>;
+    perfRun<StlMap, std::map<int, int>>("map<int, int> 10000x", [](auto& map) {
+        for (int i = 0; i < cElementsCount; ++i)
+            map.emplace(i, i);
+    });
+}
+
+TEST_CASE("std::unordered_map with 10000 elements", "[perf][StlAllocator]")
+{
+    constexpr int cElementsCount = 10000;
+    using StlMap = std::unordered_map<int, int, std::hash<int>, std::equal_to<>, StlAllocator<IntPair>>;
+    perfRun<StlMap, std::unordered_map<int, int>>("unordered_map<int, int> 10000x", [](auto& map) {
+        for (int i = 0; i < cElementsCount; ++i)
+            map.emplace(i, i);
+    });
+}
+
+} // namespace memory
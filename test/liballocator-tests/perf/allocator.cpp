@@ -296,4 +296,64 @@ TEST_CASE("2000x random number of bytes", "[perf][allocator]")
     perfShowStats(stats, "2000x random number of bytes");
 }
 
+TEST_CASE("10000x batch of 100x 48 bytes", "[perf][allocator]")
+{
+    constexpr std::size_t cAllocSize = 48;
+    constexpr std::size_t cBatchSize = 100;
+    constexpr int cIterationsCount = 10000;
+    std::array<void*, cBatchSize> ptrs{};
+    PerfStats single{};
+    PerfStats batch{};
+
+    // Initialize liballocator.
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 535;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    for (int i = 0; i < cIterationsCount; ++i) {
+        {
+            auto startAlloc = test::currentTime();
+            for (auto*& ptr : ptrs)
+                ptr = allocator::allocate(cAllocSize);
+            auto endAlloc = test::currentTime();
+
+            auto startRelease = test::currentTime();
+            for (auto* ptr : ptrs)
+                allocator::release(ptr);
+            auto endRelease = test::currentTime();
+
+            single.liballocatorAlloc += test::toMicroseconds(endAlloc - startAlloc);
+            single.liballocatorRelease += test::toMicroseconds(endRelease - startRelease);
+        }
+
+        {
+            auto startAlloc = test::currentTime();
+            REQUIRE(allocator::allocateBatch(cAllocSize, ptrs.data(), cBatchSize));
+            auto endAlloc = test::currentTime();
+
+            auto startRelease = test::currentTime();
+            allocator::releaseBatch(ptrs.data(), cBatchSize);
+            auto endRelease = test::currentTime();
+
+            batch.liballocatorAlloc += test::toMicroseconds(endAlloc - startAlloc);
+            batch.liballocatorRelease += test::toMicroseconds(endRelease - startRelease);
+        }
+    }
+
+    single.liballocatorAlloc /= double(cIterationsCount);
+    single.liballocatorRelease /= double(cIterationsCount);
+    batch.liballocatorAlloc /= double(cIterationsCount);
+    batch.liballocatorRelease /= double(cIterationsCount);
+
+    std::printf("| %-30s |  allocate   |   release   |\n", "10000x batch of 100x 48 bytes"); // NOLINT
+    std::printf("+--------------------------------+-------------+-------------+\n");          // NOLINT
+    // NOLINTNEXTLINE
+    std::printf("| %30s | %8.4f us | %8.4f us |\n", "single", single.liballocatorAlloc, single.liballocatorRelease);
+    // NOLINTNEXTLINE
+    std::printf("| %30s | %8.4f us | %8.4f us |\n", "batch", batch.liballocatorAlloc, batch.liballocatorRelease);
+    std::printf("+--------------------------------+-------------+-------------+\n"); // NOLINT
+}
+
 } // namespace memory
@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace memory {
+
+TEST_CASE("Arena properly allocates memory", "[unit][Arena]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cBlockSize = 4 * cPageSize;
+    Arena arena(heap, cBlockSize);
+    REQUIRE(arena.blocksCount() == 0);
+
+    SECTION("Allocate 0 bytes")
+    {
+        REQUIRE(arena.allocate(0) == nullptr);
+        REQUIRE(arena.blocksCount() == 0);
+
+        REQUIRE(arena.allocate(1));
+        REQUIRE(arena.allocate(0) == nullptr);
+        REQUIRE(arena.blocksCount() == 1);
+    }
+
+    SECTION("Allocations are continuous within a block")
+    {
+        constexpr std::size_t cAllocSize = 16;
+        auto* ptr1 = arena.allocate(cAllocSize, 1);
+        auto* ptr2 = arena.allocate(cAllocSize, 1);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(std::uintptr_t(ptr2) == std::uintptr_t(ptr1) + cAllocSize);
+        REQUIRE(arena.blocksCount() == 1);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize - cBlockSize);
+    }
+
+    SECTION("Allocations are properly aligned")
+    {
+        constexpr std::size_t cMaxAlignment = 128;
+        for (std::size_t alignment = 1; alignment <= cMaxAlignment; alignment *= 2) {
+            REQUIRE(arena.allocate(1, 1));
+            auto* ptr = arena.allocate(alignment, alignment);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+        }
+    }
+
+    SECTION("New blocks are taken when the current one is full")
+    {
+        constexpr std::size_t cAllocSize = 100;
+        constexpr int cAllocationsCount = 100;
+        for (int i = 0; i < cAllocationsCount; ++i) {
+            auto* ptr = arena.allocate(cAllocSize);
+            REQUIRE(ptr);
+
+            constexpr int cMemsetPattern = 0x5a;
+            std::memset(ptr, cMemsetPattern, cAllocSize);
+        }
+
+        REQUIRE(arena.blocksCount() > 1);
+    }
+
+    SECTION("Allocations bigger than the block size get a dedicated block")
+    {
+        constexpr std::size_t cAllocSize = 3 * cBlockSize;
+        auto* ptr = arena.allocate(cAllocSize);
+        REQUIRE(ptr);
+        std::memset(ptr, 0, cAllocSize);
+        REQUIRE(arena.blocksCount() == 1);
+    }
+
+    SECTION("Allocation bigger than the heap fails")
+    {
+        REQUIRE(arena.allocate(size) == nullptr);
+        REQUIRE(arena.blocksCount() == 0);
+    }
+
+    arena.reset();
+    REQUIRE(arena.blocksCount() == 0);
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Arena is properly rewound", "[unit][Arena]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    {
+        Arena arena(heap);
+        constexpr std::size_t cAllocSize = 100;
+        REQUIRE(arena.allocate(cAllocSize));
+        auto marker = arena.mark();
+        auto blocksCount = arena.blocksCount();
+
+        SECTION("Rewind within the same block")
+        {
+            auto* ptr1 = arena.allocate(cAllocSize / 2);
+            REQUIRE(ptr1);
+            arena.rewind(marker);
+
+            auto* ptr2 = arena.allocate(cAllocSize / 2);
+            REQUIRE(ptr2 == ptr1);
+        }
+
+        SECTION("Rewind releases blocks taken after the marker")
+        {
+            constexpr int cAllocationsCount = 20;
+            for (int i = 0; i < cAllocationsCount; ++i)
+                REQUIRE(arena.allocate(cAllocSize));
+
+            REQUIRE(arena.blocksCount() > blocksCount);
+            arena.rewind(marker);
+            REQUIRE(arena.blocksCount() == blocksCount);
+            REQUIRE(arena.mark().cursor == marker.cursor);
+        }
+
+        SECTION("Rewind to the empty arena releases all blocks")
+        {
+            Arena::Marker emptyMarker{};
+            arena.rewind(emptyMarker);
+            REQUIRE(arena.blocksCount() == 0);
+            REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+        }
+    }
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+} // namespace memory
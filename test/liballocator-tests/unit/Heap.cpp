@@ -0,0 +1,574 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <Cache.hpp>
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/ObjectCache.hpp>
+#include <allocator/PageProvider.hpp>
+#ifdef __linux__
+#include <allocator/MmapPageProvider.hpp>
+#endif
+#include <utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("Heap is properly cleared", "[unit][Heap]")
+{
+    Heap heap;
+    heap.clear();
+
+    auto stats = heap.getStats();
+    REQUIRE(stats.totalMemorySize == 0);
+    REQUIRE(stats.reservedMemorySize == 0);
+    REQUIRE(stats.userMemorySize == 0);
+    REQUIRE(stats.allocatedMemorySize == 0);
+    REQUIRE(stats.freeMemorySize == 0);
+    REQUIRE(!heap.reset());
+}
+
+TEST_CASE("Heaps are independent of each other", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 128;
+    auto size = cPageSize * cPagesCount;
+    auto memory1 = test::alignedAlloc(cPageSize, size);
+    auto memory2 = test::alignedAlloc(cPageSize, size);
+
+    Heap heap1;
+    Heap heap2;
+    REQUIRE(heap1.init(std::uintptr_t(memory1.get()), std::uintptr_t(memory1.get() + size), cPageSize));
+    REQUIRE(heap2.init(std::uintptr_t(memory2.get()), std::uintptr_t(memory2.get() + size), cPageSize));
+
+    constexpr std::size_t cAllocSize = 100;
+    auto* ptr1 = heap1.allocate(cAllocSize);
+    auto* ptr2 = heap2.allocate(cAllocSize);
+    REQUIRE(ptr1);
+    REQUIRE(ptr2);
+    REQUIRE(std::uintptr_t(ptr1) >= std::uintptr_t(memory1.get()));
+    REQUIRE(std::uintptr_t(ptr1) < std::uintptr_t(memory1.get() + size));
+    REQUIRE(std::uintptr_t(ptr2) >= std::uintptr_t(memory2.get()));
+    REQUIRE(std::uintptr_t(ptr2) < std::uintptr_t(memory2.get() + size));
+
+    REQUIRE(heap1.getStats().allocatedMemorySize > 0);
+    REQUIRE(heap2.getStats().allocatedMemorySize > 0);
+
+    heap1.release(ptr1);
+    REQUIRE(heap1.getStats().allocatedMemorySize == 0);
+    REQUIRE(heap2.getStats().allocatedMemorySize > 0);
+
+    heap2.release(ptr2);
+    REQUIRE(heap2.getStats().allocatedMemorySize == 0);
+}
+
+TEST_CASE("Heap releases all allocations on reset", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount1 = 535;
+    constexpr std::size_t cPagesCount2 = 87;
+    auto size1 = cPageSize * cPagesCount1;
+    auto size2 = cPageSize * cPagesCount2;
+    auto memory1 = test::alignedAlloc(cPageSize, size1);
+    auto memory2 = test::alignedAlloc(cPageSize, size2);
+
+    constexpr int cRegionsCount = 3;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory1.get()), size1}, {std::uintptr_t(memory2.get()), size2}, {0, 0}}
+    };
+
+    Heap heap;
+    REQUIRE(heap.init(regions.data(), cPageSize));
+    auto initialStats = heap.getStats();
+
+    constexpr int cIterationsCount = 3;
+    for (int i = 0; i < cIterationsCount; ++i) {
+        constexpr std::size_t cAllocationsCount = 200;
+        constexpr std::size_t cMaxAllocSize = 1000;
+        for (std::size_t j = 0; j < cAllocationsCount; ++j) {
+            auto allocSize = (j * 37) % cMaxAllocSize + 1; // NOLINT
+            if (auto* ptr = heap.allocate(allocSize)) {
+                constexpr int cMemsetPattern = 0x5a;
+                std::memset(ptr, cMemsetPattern, allocSize);
+            }
+        }
+
+        REQUIRE(heap.getStats().allocatedMemorySize > 0);
+        REQUIRE(heap.reset());
+
+        auto stats = heap.getStats();
+        REQUIRE(stats.totalMemorySize == initialStats.totalMemorySize);
+        REQUIRE(stats.reservedMemorySize == initialStats.reservedMemorySize);
+        REQUIRE(stats.userMemorySize == initialStats.userMemorySize);
+        REQUIRE(stats.allocatedMemorySize == 0);
+        REQUIRE(stats.freeMemorySize == initialStats.freeMemorySize);
+    }
+
+    // Whole region should be available as a single block after reset.
+    auto* ptr = heap.allocate((cPagesCount1 - 1) * cPageSize);
+    REQUIRE(ptr);
+    heap.release(ptr);
+}
+
+TEST_CASE("Heap allocates aligned memory blocks", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    SECTION("Supported alignments")
+    {
+        constexpr std::array<std::size_t, 5> cAllocSizes = {0, 1, 24, 100, cPageSize};
+        for (std::size_t alignment = 1; alignment <= cPageSize; alignment *= 2) {
+            for (auto allocSize : cAllocSizes) {
+                auto* ptr = heap.allocateAligned(allocSize, alignment);
+                REQUIRE(ptr);
+                REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+                REQUIRE(heap.usableSize(ptr) >= allocSize);
+                heap.release(ptr);
+            }
+        }
+    }
+
+    SECTION("Alignments bigger than the page size")
+    {
+        constexpr std::array<std::size_t, 4> cAllocSizes = {0, 1, cPageSize, 3 * cPageSize};
+        for (std::size_t alignment = 2 * cPageSize; alignment <= 16 * cPageSize; alignment *= 2) {
+            for (auto allocSize : cAllocSizes) {
+                // Unaligned page in front makes sure, that the head of the over-allocated pages is given back.
+                auto* padding = heap.allocate(cPageSize);
+                auto* ptr = heap.allocateAligned(allocSize, alignment);
+                REQUIRE(ptr);
+                REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+                REQUIRE(heap.usableSize(ptr) == std::max(utils::roundUp(allocSize, cPageSize), cPageSize));
+                heap.release(padding);
+                heap.release(ptr);
+            }
+        }
+    }
+
+    SECTION("Unsupported alignments")
+    {
+        REQUIRE(heap.allocateAligned(1, 0) == nullptr);
+        REQUIRE(heap.allocateAligned(1, 3) == nullptr);
+        REQUIRE(heap.allocateAligned(1, size) == nullptr);
+    }
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Heap reclaims memory from shrinkers when it runs low", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    // User cache, that keeps single pages and gives them back on demand.
+    struct PageCache {
+        Heap* heap;
+        std::vector<void*> pages;
+        std::size_t callsCount;
+    };
+
+    PageCache pageCache{&heap, {}, 0};
+    auto shrink = [](std::size_t shrinkSize, void* arg) {
+        auto* cache = static_cast<PageCache*>(arg);
+        ++cache->callsCount;
+
+        std::size_t releasedSize = 0;
+        for (; releasedSize < shrinkSize && !cache->pages.empty(); releasedSize += cPageSize) {
+            cache->heap->release(cache->pages.back());
+            cache->pages.pop_back();
+        }
+
+        return releasedSize;
+    };
+
+    allocator::Shrinker shrinker{shrink, &pageCache};
+    auto fillHeap = [&](std::vector<void*>& pages) {
+        for (auto* ptr = heap.allocate(cPageSize); ptr != nullptr; ptr = heap.allocate(cPageSize))
+            pages.push_back(ptr);
+    };
+
+    SECTION("Invalid shrinkers are rejected")
+    {
+        REQUIRE(!heap.addShrinker({nullptr, nullptr}));
+
+        // One slot is taken by the heap itself.
+        std::size_t count = 0;
+        for (; heap.addShrinker(shrinker); ++count) {}
+        REQUIRE(count == 7);
+    }
+
+    SECTION("Allocation succeeds after shrinkers release memory")
+    {
+        fillHeap(pageCache.pages);
+        REQUIRE(heap.allocate(cPageSize) == nullptr);
+
+        REQUIRE(heap.addShrinker(shrinker));
+        auto* ptr = heap.allocate(2 * cPageSize);
+        REQUIRE(ptr);
+        REQUIRE(pageCache.callsCount == 1);
+        heap.release(ptr);
+
+        heap.removeShrinker(shrinker);
+        fillHeap(pageCache.pages);
+        REQUIRE(heap.allocate(cPageSize) == nullptr);
+        REQUIRE(pageCache.callsCount == 1);
+    }
+
+    SECTION("Empty zones retained by object caches are reclaimed first")
+    {
+        auto* cache = heap.cacheCreate("test", 32, alignof(std::uint64_t), {});
+        REQUIRE(cache);
+        cacheRelease(cache, cacheAllocate(cache));
+        REQUIRE(cache->zonesCount() == 1);
+
+        REQUIRE(heap.addShrinker(shrinker));
+        std::vector<void*> pages;
+        fillHeap(pages);
+        REQUIRE(cache->zonesCount() == 0);
+        REQUIRE(pageCache.callsCount == 1);
+
+        for (auto* ptr : pages)
+            heap.release(ptr);
+
+        cacheDestroy(cache);
+    }
+
+    SECTION("Shrinkers are called once per drop below the low watermark")
+    {
+        constexpr std::size_t cLowWatermark = 8 * cPageSize;
+        constexpr std::size_t cHighWatermark = 16 * cPageSize;
+        heap.setWatermarks(cLowWatermark, cHighWatermark);
+        REQUIRE(heap.addShrinker(shrinker));
+
+        std::size_t count = 0;
+        for (; pageCache.callsCount == 0 && count < cPagesCount; ++count)
+            pageCache.pages.push_back(heap.allocate(cPageSize));
+
+        REQUIRE(pageCache.callsCount == 1);
+        REQUIRE((count + 1) * cPageSize + cLowWatermark >= freeMemorySize);
+        REQUIRE(heap.getStats().freeMemorySize >= cHighWatermark);
+
+        // Free memory has not reached the high watermark since the last call, so shrinker is not called again.
+        std::vector<void*> pages;
+        auto dropBelowLowWatermark = [&] {
+            auto pagesCount = (heap.getStats().freeMemorySize - cLowWatermark) / cPageSize + 2;
+            for (std::size_t i = 0; i < pagesCount; ++i)
+                pages.push_back(heap.allocate(cPageSize));
+        };
+
+        dropBelowLowWatermark();
+        REQUIRE(pageCache.callsCount == 1);
+
+        // Once the free memory recovers, the next drop below the low watermark calls the shrinker again.
+        for (auto* ptr : pageCache.pages)
+            heap.release(ptr);
+
+        pageCache.pages.clear();
+        dropBelowLowWatermark();
+        REQUIRE(pageCache.callsCount == 2);
+
+        for (auto* ptr : pages)
+            heap.release(ptr);
+    }
+
+    SECTION("Shrinkers called at the low watermark may release and allocate")
+    {
+        constexpr std::size_t cLowWatermark = 8 * cPageSize;
+        constexpr std::size_t cHighWatermark = 16 * cPageSize;
+        constexpr std::size_t cObjectSize = 48;
+        heap.setWatermarks(cLowWatermark, cHighWatermark);
+
+        // Shrinker keeps a record of each call in the heap, while the watermark is crossed by allocating new zones.
+        struct Recorder {
+            Heap* heap;
+            allocator::Shrinker shrinker;
+            std::vector<void*> records;
+        };
+
+        Recorder recorder{&heap, shrinker, {}};
+        auto shrinkAndRecord = [](std::size_t shrinkSize, void* arg) {
+            auto* owner = static_cast<Recorder*>(arg);
+            if (auto* record = owner->heap->allocate(cObjectSize))
+                owner->records.push_back(record);
+
+            return owner->shrinker.shrink(shrinkSize, owner->shrinker.arg);
+        };
+
+        allocator::Shrinker recordingShrinker{shrinkAndRecord, &recorder};
+        REQUIRE(heap.addShrinker(recordingShrinker));
+        for (std::size_t i = 0; i < cPagesCount / 2; ++i)
+            pageCache.pages.push_back(heap.allocate(cPageSize));
+
+        std::vector<void*> objects;
+        while (pageCache.callsCount == 0) {
+            auto* object = heap.allocate(cObjectSize);
+            REQUIRE(object);
+            std::memset(object, 0x5a, cObjectSize);
+            objects.push_back(object);
+        }
+
+        REQUIRE(recorder.records.size() == 1);
+        REQUIRE(heap.getStats().freeMemorySize >= cHighWatermark);
+        for (auto* object : objects) {
+            REQUIRE(heap.usableSize(object) >= cObjectSize);
+            REQUIRE(object != recorder.records.front());
+            heap.release(object);
+        }
+
+        heap.release(recorder.records.front());
+        heap.removeShrinker(recordingShrinker);
+    }
+
+    for (auto* ptr : pageCache.pages)
+        heap.release(ptr);
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Heap keeps the emergency reserve for critical allocations", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    constexpr std::size_t cReservePagesCount = 8;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    heap.setEmergencyReserve(cReservePagesCount * cPageSize - 1);
+    auto stats = heap.getStats();
+    REQUIRE(stats.emergencySize == cReservePagesCount * cPageSize);
+    REQUIRE(stats.emergencyUsedSize == 0);
+
+    std::vector<void*> ptrs;
+    for (auto* ptr = heap.allocate(cPageSize); ptr != nullptr; ptr = heap.allocate(cPageSize))
+        ptrs.push_back(ptr);
+
+    REQUIRE(heap.getStats().freeMemorySize >= cReservePagesCount * cPageSize);
+    REQUIRE(heap.getStats().emergencyUsedSize == 0);
+
+    SECTION("Critical allocations use the reserve")
+    {
+        auto* ptr = heap.allocateCritical(2 * cPageSize);
+        REQUIRE(ptr);
+        REQUIRE(heap.getStats().emergencyUsedSize == 2 * cPageSize);
+        REQUIRE(heap.allocate(cPageSize) == nullptr);
+
+        std::size_t count = 0;
+        for (auto* page = heap.allocateCritical(cPageSize); page != nullptr; page = heap.allocateCritical(cPageSize)) {
+            ptrs.push_back(page);
+            ++count;
+        }
+
+        REQUIRE(count == cReservePagesCount - 2);
+        REQUIRE(heap.getStats().emergencyUsedSize == cReservePagesCount * cPageSize);
+
+        heap.release(ptr);
+        REQUIRE(heap.getStats().emergencyUsedSize == (cReservePagesCount - 2) * cPageSize);
+    }
+
+    SECTION("Small critical allocations get new zones from the reserve")
+    {
+        constexpr std::size_t cAllocSize = 32;
+        for (auto* ptr = heap.allocate(cAllocSize); ptr != nullptr; ptr = heap.allocate(cAllocSize))
+            ptrs.push_back(ptr);
+
+        auto* ptr = heap.allocateCritical(cAllocSize);
+        REQUIRE(ptr);
+        REQUIRE(heap.getStats().emergencyUsedSize > 0);
+        ptrs.push_back(ptr);
+    }
+
+    for (auto* ptr : ptrs)
+        heap.release(ptr);
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    REQUIRE(heap.getStats().emergencyUsedSize == 0);
+}
+
+TEST_CASE("Heap grows with the page provider", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 32;
+    constexpr std::size_t cPoolPagesCount = 1024;
+    auto size = cPageSize * cPagesCount;
+    auto poolSize = cPageSize * cPoolPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto pool = test::alignedAlloc(cPageSize, poolSize);
+    StaticPageProvider provider(std::uintptr_t(pool.get()), std::uintptr_t(pool.get() + poolSize));
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    heap.setPageProvider(&provider);
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    // Sizes, that cannot be served by any region, are rejected before the provider is asked.
+    REQUIRE(heap.allocate(std::numeric_limits<std::size_t>::max() - 100) == nullptr);
+    REQUIRE(heap.allocate(std::numeric_limits<std::size_t>::max() / 2) == nullptr);
+    REQUIRE(provider.remainingSize() == poolSize);
+
+    // Allocations, that would not fit into the initial region, are served from the regions obtained from provider.
+    constexpr std::size_t cAllocSize = 100;
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < 4 * freeMemorySize / cAllocSize; ++i) {
+        ptrs.push_back(heap.allocate(cAllocSize));
+        REQUIRE(ptrs.back());
+    }
+
+    REQUIRE(provider.remainingSize() < poolSize);
+    REQUIRE(heap.getStats().totalMemorySize > size);
+
+    for (auto* ptr : ptrs)
+        heap.release(ptr);
+
+    heap.clear();
+    REQUIRE(provider.remainingSize() == poolSize);
+}
+
+TEST_CASE("Heap gives provided regions back on destruction", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 32;
+    constexpr std::size_t cPoolPagesCount = 1024;
+    auto size = cPageSize * cPagesCount;
+    auto poolSize = cPageSize * cPoolPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto pool = test::alignedAlloc(cPageSize, poolSize);
+    StaticPageProvider provider(std::uintptr_t(pool.get()), std::uintptr_t(pool.get() + poolSize));
+
+    {
+        Heap heap;
+        REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+        heap.setPageProvider(&provider);
+        REQUIRE(heap.allocate(2 * size));
+        REQUIRE(provider.remainingSize() < poolSize);
+    }
+
+    REQUIRE(provider.remainingSize() == poolSize);
+}
+
+#ifdef __linux__
+TEST_CASE("Heap gives free pages back on trim", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cHeapSize = 256 * cPageSize;
+    MmapPageProvider provider;
+    auto region = provider.allocate(cHeapSize);
+    REQUIRE(region.size == cHeapSize);
+
+    Heap heap;
+    REQUIRE(heap.init(region.address, region.address + region.size, cPageSize, true));
+    heap.setPageProvider(&provider);
+    REQUIRE(heap.trim() != 0);
+
+    constexpr std::size_t cAllocSize = 16 * cPageSize;
+    auto* ptr = heap.allocate(cAllocSize);
+    REQUIRE(ptr);
+    std::memset(ptr, 1, cAllocSize);
+    heap.release(ptr);
+
+    REQUIRE(heap.trim() == cAllocSize);
+    REQUIRE(heap.trim() == 0);
+
+    // Decommitted pages read as zeros, so they are handed out by allocateZeroed() without clearing.
+    auto* bytes = static_cast<std::byte*>(heap.allocateZeroed(cAllocSize));
+    REQUIRE(bytes);
+    REQUIRE(std::all_of(bytes, bytes + cAllocSize, [](std::byte value) { return value == std::byte{0}; }));
+    heap.release(bytes);
+
+    heap.clear();
+    provider.release(region);
+}
+
+TEST_CASE("Heap moves big blocks instead of copying them", "[unit][Heap]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cHeapSize = 256 * cPageSize;
+    constexpr std::size_t cDirectThreshold = 64 * cPageSize;
+    MmapPageProvider provider;
+    auto region = provider.allocate(cHeapSize);
+    REQUIRE(region.size == cHeapSize);
+
+    Heap heap;
+    REQUIRE(heap.init(region.address, region.address + region.size, cPageSize, true));
+    heap.setPageProvider(&provider, cDirectThreshold);
+
+    constexpr std::size_t cSize = 2 * cDirectThreshold;
+    auto* bytes = static_cast<std::uint8_t*>(heap.allocate(cSize));
+    REQUIRE(bytes);
+    REQUIRE((std::uintptr_t(bytes) < region.address || std::uintptr_t(bytes) >= region.address + region.size));
+    for (std::size_t i = 0; i < cSize; ++i)
+        bytes[i] = static_cast<std::uint8_t>(i % 251); // NOLINT
+
+    constexpr std::size_t cNewSize = 8 * cSize;
+    auto* moved = static_cast<std::uint8_t*>(heap.reallocate(bytes, cNewSize));
+    REQUIRE(moved);
+    REQUIRE(heap.usableSize(moved) >= cNewSize);
+    bool preserved = true;
+    for (std::size_t i = 0; i < cSize; ++i)
+        preserved = preserved && (moved[i] == static_cast<std::uint8_t>(i % 251)); // NOLINT
+
+    REQUIRE(preserved);
+
+    std::memset(moved, 0, cNewSize);
+    heap.release(moved);
+
+    heap.clear();
+    provider.release(region);
+}
+#endif
+
+} // namespace memory
@@ -0,0 +1,175 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Arena.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/MemoryResource.hpp>
+#include <allocator/allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("HeapResource properly allocates and releases memory", "[unit][MemoryResource]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    HeapResource resource(heap);
+    REQUIRE(&resource.heap() == &heap);
+
+    SECTION("Allocations are properly aligned")
+    {
+        // Alignments bigger than the page size are served from over-allocated pages.
+        for (std::size_t alignment = 1; alignment <= 8 * cPageSize; alignment *= 2) {
+            for (std::size_t allocSize : {std::size_t(0), std::size_t(1), std::size_t(3), 2 * cPageSize + 1}) {
+                auto* ptr = resource.allocate(allocSize, alignment);
+                REQUIRE(ptr);
+                REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+                resource.deallocate(ptr, allocSize, alignment);
+            }
+        }
+    }
+
+    SECTION("Containers use memory from the heap")
+    {
+        constexpr int cElementsCount = 100;
+
+        {
+            std::pmr::vector<int> vector(&resource);
+            std::pmr::list<int> list(&resource);
+            std::pmr::map<int, std::pmr::string> map(&resource);
+
+            for (int i = 0; i < cElementsCount; ++i) {
+                vector.push_back(i);
+                list.push_back(i);
+                map.emplace(i, "string that is long enough to not fit into the small buffer");
+            }
+
+            REQUIRE(heap.getStats().freeMemorySize < freeMemorySize);
+        }
+    }
+
+    SECTION("Resources are compared by identity")
+    {
+        HeapResource other(heap);
+        REQUIRE(resource == resource);
+        REQUIRE(resource != other);
+        REQUIRE(resource != *std::pmr::new_delete_resource());
+    }
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("ArenaResource properly allocates memory", "[unit][MemoryResource]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    Arena arena(heap);
+    ArenaResource resource(arena);
+    REQUIRE(&resource.arena() == &arena);
+
+    SECTION("Allocations are properly aligned")
+    {
+        for (std::size_t alignment = 1; alignment <= cPageSize; alignment *= 2) {
+            auto* ptr = resource.allocate(1, alignment);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignment == 0);
+        }
+    }
+
+    SECTION("Containers use memory from the arena")
+    {
+        constexpr int cElementsCount = 100;
+        std::pmr::vector<int> vector(&resource);
+        std::pmr::list<int> list(&resource);
+
+        for (int i = 0; i < cElementsCount; ++i) {
+            vector.push_back(i);
+            list.push_back(i);
+        }
+
+        REQUIRE(arena.blocksCount() > 0);
+    }
+
+    arena.reset();
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Global memory resource uses liballocator", "[unit][MemoryResource]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = allocator::getStats().freeMemorySize;
+
+    auto* resource = allocator::memoryResource();
+    REQUIRE(resource == allocator::memoryResource());
+
+    {
+        constexpr int cElementsCount = 100;
+        std::pmr::list<int> list(resource);
+        for (int i = 0; i < cElementsCount; ++i)
+            list.push_back(i);
+
+        REQUIRE(allocator::getStats().freeMemorySize < freeMemorySize);
+    }
+
+    REQUIRE(allocator::getStats().freeMemorySize == freeMemorySize);
+    allocator::clear();
+}
+
+} // namespace memory
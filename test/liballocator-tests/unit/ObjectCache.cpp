@@ -0,0 +1,451 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <Cache.hpp>
+#include <TestUtils.hpp>
+#include <Zone.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/ObjectCache.hpp>
+#include <allocator/allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace memory {
+
+TEST_CASE("Cache packs objects with their exact size", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    SECTION("Objects without hooks")
+    {
+        constexpr std::size_t cObjectSize = 24;
+        auto* cache = heap.cacheCreate("test", cObjectSize, alignof(std::uint64_t), {});
+        REQUIRE(cache);
+        REQUIRE(cache->objectSize() == cObjectSize);
+        REQUIRE(cache->objectsPerZone() == (cPageSize - sizeof(Zone)) / cObjectSize);
+        REQUIRE(cache->zonesCount() == 0);
+
+        auto* ptr1 = cacheAllocate(cache);
+        auto* ptr2 = cacheAllocate(cache);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        auto distance = std::uintptr_t(ptr1) > std::uintptr_t(ptr2) ? std::uintptr_t(ptr1) - std::uintptr_t(ptr2)
+                                                                    : std::uintptr_t(ptr2) - std::uintptr_t(ptr1);
+        REQUIRE(distance == cObjectSize);
+        REQUIRE(cache->zonesCount() == 1);
+
+        cacheRelease(cache, ptr1);
+        cacheRelease(cache, ptr2);
+        cacheDestroy(cache);
+    }
+
+    SECTION("Objects with alignment bigger than their size")
+    {
+        constexpr std::size_t cObjectSize = 40;
+        constexpr std::size_t cAlignment = 64;
+        auto* cache = heap.cacheCreate("test", cObjectSize, cAlignment, {});
+        REQUIRE(cache);
+        REQUIRE(cache->objectsPerZone() == (cPageSize - sizeof(Zone)) / cAlignment);
+
+        std::array<void*, 10> ptrs{};
+        for (auto*& ptr : ptrs) {
+            ptr = cacheAllocate(cache);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % cAlignment == 0);
+            std::memset(ptr, 0, cObjectSize);
+        }
+
+        for (auto* ptr : ptrs)
+            cacheRelease(cache, ptr);
+
+        cacheDestroy(cache);
+    }
+
+    SECTION("Invalid parameters")
+    {
+        REQUIRE(heap.cacheCreate("test", 0, 1, {}) == nullptr);
+        REQUIRE(heap.cacheCreate("test", 1, 3, {}) == nullptr);
+        REQUIRE(heap.cacheCreate("test", cPageSize - sizeof(Zone) + 1, 1, {}) == nullptr);
+        REQUIRE(heap.cacheCreate("test", 1, 2 * cPageSize, {}) == nullptr);
+    }
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Cache objects can be given back to the heap", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cObjectSize = 24;
+    auto* cache = heap.cacheCreate("test", cObjectSize, alignof(std::uint64_t), {});
+    REQUIRE(cache);
+
+    std::array<void*, 16> ptrs{};
+    for (auto*& ptr : ptrs) {
+        ptr = cacheAllocate(cache);
+        REQUIRE(ptr);
+        REQUIRE(heap.usableSize(ptr) == cObjectSize);
+    }
+
+    // Objects of the same size from the heap itself must not be mistaken for the cache objects.
+    auto* heapPtr = heap.allocate(cObjectSize);
+    REQUIRE(heapPtr);
+    REQUIRE(heap.usableSize(heapPtr) != cObjectSize);
+
+    SECTION("Release to the heap")
+    {
+        for (auto* ptr : ptrs)
+            heap.release(ptr);
+    }
+
+    SECTION("Release to the heap in batch")
+    {
+        heap.releaseBatch(ptrs.data(), ptrs.size());
+    }
+
+    SECTION("Reallocate through the heap")
+    {
+        auto* ptr = heap.reallocate(ptrs[0], 2 * cObjectSize);
+        REQUIRE(ptr);
+        REQUIRE(heap.usableSize(ptr) >= 2 * cObjectSize);
+        heap.release(ptr);
+
+        for (std::size_t i = 1; i < ptrs.size(); ++i)
+            cacheRelease(cache, ptrs.at(i));
+    }
+
+    heap.release(heapPtr);
+    REQUIRE(cache->zonesCount() == 1);
+    REQUIRE(cacheDestroy(cache));
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Cache is not destroyed while objects are allocated from it", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    constexpr std::size_t cObjectSize = 24;
+    auto* cache = heap.cacheCreate("test", cObjectSize, alignof(std::uint64_t), {});
+    REQUIRE(cache);
+
+    SECTION("Object in a partial zone")
+    {
+        auto* ptr = cacheAllocate(cache);
+        REQUIRE(ptr);
+        REQUIRE(!cacheDestroy(cache));
+        REQUIRE(cache->zonesCount() == 1);
+
+        cacheRelease(cache, ptr);
+    }
+
+    SECTION("Objects in a full zone")
+    {
+        std::array<void*, 16> ptrs{};
+        REQUIRE(ptrs.size() >= cache->objectsPerZone());
+        for (std::size_t i = 0; i < cache->objectsPerZone(); ++i) {
+            ptrs.at(i) = cacheAllocate(cache);
+            REQUIRE(ptrs.at(i));
+        }
+
+        REQUIRE(!cacheDestroy(cache));
+        REQUIRE(cache->zonesCount() == 1);
+
+        for (std::size_t i = 0; i < cache->objectsPerZone(); ++i)
+            cacheRelease(cache, ptrs.at(i));
+    }
+
+    REQUIRE(cacheDestroy(cache));
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Cache colors consecutive zones", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    SECTION("Slack is spread over the cache lines")
+    {
+        constexpr std::size_t cObjectSize = 960;
+        constexpr std::size_t cZonesCount = 8;
+        auto* cache = heap.cacheCreate("test", cObjectSize, alignof(std::uint64_t), {});
+        REQUIRE(cache);
+
+        auto slack = (cPageSize - sizeof(Zone)) % cObjectSize;
+        REQUIRE(cache->colorsCount() == slack / config::cCacheLineSize + 1);
+        REQUIRE(cache->colorsCount() > 1);
+
+        std::array<void*, cZonesCount * ((cPageSize - sizeof(Zone)) / cObjectSize)> ptrs{};
+        REQUIRE(ptrs.size() == cZonesCount * cache->objectsPerZone());
+        for (auto*& ptr : ptrs) {
+            ptr = cacheAllocate(cache);
+            REQUIRE(ptr);
+            std::memset(ptr, 0, cObjectSize);
+        }
+
+        REQUIRE(cache->zonesCount() == cZonesCount);
+
+        // Zones are colored in turns, so each color is used by at least one of the allocated zones.
+        std::array<bool, cZonesCount> colorUsed{};
+        for (auto* ptr : ptrs) {
+            auto colorOffset = std::uintptr_t(ptr) % cPageSize % cObjectSize;
+            REQUIRE(colorOffset % config::cCacheLineSize == 0);
+            REQUIRE(colorOffset <= slack);
+            colorUsed.at(colorOffset / config::cCacheLineSize) = true;
+        }
+
+        auto colorsUsed = std::size_t(std::count(colorUsed.begin(), colorUsed.end(), true));
+        REQUIRE(colorsUsed == cache->colorsCount());
+
+        for (auto* ptr : ptrs)
+            cacheRelease(cache, ptr);
+
+        cacheDestroy(cache);
+    }
+
+    SECTION("Coloring preserves the alignment")
+    {
+        constexpr std::size_t cObjectSize = 1000;
+        constexpr std::size_t cAlignment = 256;
+        auto* cache = heap.cacheCreate("test", cObjectSize, cAlignment, {});
+        REQUIRE(cache);
+        REQUIRE(cache->colorsCount() == (cPageSize - sizeof(Zone)) % 1024 / cAlignment + 1);
+
+        std::array<void*, 16> ptrs{};
+        for (auto*& ptr : ptrs) {
+            ptr = cacheAllocate(cache);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % cAlignment == 0);
+        }
+
+        for (auto* ptr : ptrs)
+            cacheRelease(cache, ptr);
+
+        cacheDestroy(cache);
+    }
+
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+TEST_CASE("Cache calls hooks at the proper moments", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    struct Counters {
+        std::size_t ctor;
+        std::size_t dtor;
+        std::size_t init;
+        std::size_t fini;
+    };
+
+    Counters counters{};
+    CacheHooks hooks{};
+    hooks.ctor = [](void* /*unused*/, void* arg) { ++static_cast<Counters*>(arg)->ctor; };
+    hooks.dtor = [](void* /*unused*/, void* arg) { ++static_cast<Counters*>(arg)->dtor; };
+    hooks.init = [](void* object, void* arg) {
+        std::memset(object, 0, sizeof(std::uint64_t));
+        ++static_cast<Counters*>(arg)->init;
+    };
+    hooks.fini = [](void* /*unused*/, void* arg) { ++static_cast<Counters*>(arg)->fini; };
+    hooks.arg = &counters;
+
+    constexpr std::size_t cObjectSize = 24;
+    auto* cache = heap.cacheCreate("test", cObjectSize, alignof(std::uint64_t), hooks);
+    REQUIRE(cache);
+    auto objectsPerZone = cache->objectsPerZone();
+    REQUIRE(objectsPerZone > 1);
+
+    SECTION("Objects are initialized once per zone")
+    {
+        auto* ptr = static_cast<std::uint64_t*>(cacheAllocate(cache));
+        REQUIRE(ptr);
+        REQUIRE(*ptr == 0);
+        REQUIRE(counters.init == objectsPerZone);
+        REQUIRE(counters.ctor == 1);
+
+        constexpr std::uint64_t cValue = 0x5a5a5a5a;
+        *ptr = cValue;
+        cacheRelease(cache, ptr);
+        REQUIRE(counters.dtor == 1);
+
+        // Released object keeps its state, because free list is not stored in the object.
+        ptr = static_cast<std::uint64_t*>(cacheAllocate(cache));
+        REQUIRE(*ptr == cValue);
+        REQUIRE(counters.init == objectsPerZone);
+        REQUIRE(counters.ctor == 2);
+        cacheRelease(cache, ptr);
+    }
+
+    SECTION("One empty zone is kept in the cache")
+    {
+        constexpr std::size_t cZonesCount = 3;
+        std::array<void*, 64> ptrs{};
+        REQUIRE(ptrs.size() >= cZonesCount * objectsPerZone);
+
+        for (std::size_t i = 0; i < cZonesCount * objectsPerZone; ++i)
+            REQUIRE((ptrs.at(i) = cacheAllocate(cache)));
+
+        REQUIRE(cache->zonesCount() == cZonesCount);
+        REQUIRE(counters.init == cZonesCount * objectsPerZone);
+
+        for (std::size_t i = 0; i < cZonesCount * objectsPerZone; ++i)
+            cacheRelease(cache, ptrs.at(i));
+
+        REQUIRE(cache->zonesCount() == 1);
+        REQUIRE(counters.fini == (cZonesCount - 1) * objectsPerZone);
+        REQUIRE(counters.dtor == cZonesCount * objectsPerZone);
+    }
+
+    cacheDestroy(cache);
+    REQUIRE(counters.fini == counters.init);
+    REQUIRE(counters.dtor == counters.ctor);
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+}
+
+namespace {
+
+struct Object {
+    Object() { ++constructedCount; }
+    Object(const Object&) = delete;
+    Object(Object&&) = delete;
+    ~Object() { --constructedCount; }
+    Object& operator=(const Object&) = delete;
+    Object& operator=(Object&&) = delete;
+
+    static inline int constructedCount{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+    std::array<char, 100> buffer{};       // NOLINT(readability-magic-numbers)
+    int value{};
+};
+
+} // namespace
+
+TEST_CASE("ObjectCache keeps the objects constructed", "[unit][ObjectCache]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    SECTION("Cache in the given heap")
+    {
+        Heap heap;
+        REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+        {
+            ObjectCache<Object> cache(heap, "objects");
+            REQUIRE(cache.isValid());
+
+            auto* object = cache.allocate();
+            REQUIRE(object);
+            REQUIRE(Object::constructedCount > 0);
+            auto constructedCount = Object::constructedCount;
+
+            constexpr int cValue = 7;
+            object->value = cValue;
+            cache.release(object);
+
+            object = cache.allocate();
+            REQUIRE(object->value == cValue);
+            REQUIRE(Object::constructedCount == constructedCount);
+            cache.release(object);
+        }
+
+        REQUIRE(Object::constructedCount == 0);
+    }
+
+    SECTION("Cache in the global heap")
+    {
+        REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+        {
+            ObjectCache<Object> cache("objects");
+            REQUIRE(cache.isValid());
+
+            auto* object = cache.allocate();
+            REQUIRE(object);
+            cache.release(object);
+        }
+
+        REQUIRE(Object::constructedCount == 0);
+        allocator::clear();
+    }
+
+    SECTION("Objects bigger than the page")
+    {
+        Heap heap;
+        REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+        ObjectCache<std::array<char, cPageSize>> cache(heap, "big");
+        REQUIRE(!cache.isValid());
+    }
+}
+
+} // namespace memory
@@ -56,6 +56,46 @@ TEST_CASE("Page is properly initialized", "[unit][Page]")
     REQUIRE(page->address() == 0);
     REQUIRE(page->groupSize() == 0);
     REQUIRE(!page->isUsed());
+    REQUIRE(!page->isZeroed());
+    REQUIRE(!page->isZone());
+}
+
+TEST_CASE("Page flags are independent of each other", "[unit][Page]")
+{
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->init();
+
+    constexpr std::size_t cGroupSize = 13;
+    page->setGroupSize(cGroupSize);
+    page->setZeroed(true);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(!page->isUsed());
+    REQUIRE(page->isZeroed());
+
+    page->setUsed(true);
+    page->setZeroed(false);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(page->isUsed());
+    REQUIRE(!page->isZeroed());
+
+    constexpr std::size_t cZoneIdx = 7;
+    page->setZone(true);
+    page->setZoneIdx(cZoneIdx);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(page->isUsed());
+    REQUIRE(page->isZone());
+    REQUIRE(page->zoneIdx() == cZoneIdx);
+
+    int owner{};
+    page->setOwner(&owner);
+    REQUIRE(page->owner() == &owner);
+    REQUIRE(page->groupSize() == cGroupSize);
+    REQUIRE(page->zoneIdx() == cZoneIdx);
+
+    page->setOwner(nullptr);
+    REQUIRE(page->owner() == nullptr);
+    REQUIRE(page->prev() == nullptr);
 }
 
 TEST_CASE("Accessing siblings works as expected", "[unit][Page]")
@@ -33,14 +33,18 @@
 #include <Page.hpp>
 #include <PageAllocator.hpp>
 #include <TestUtils.hpp>
+#include <allocator/PageProvider.hpp>
 #include <allocator/Region.hpp>
+#include <utils.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <limits>
 #include <vector>
 
 namespace memory {
@@ -786,4 +790,863 @@ TEST_CASE("Pages are correctly released", "[unit][PageAllocator]")
     REQUIRE(stats.freePagesCount == freePages);
 }
 
+TEST_CASE("Single pages are served from the page cache", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    PageAllocator pageAllocator;
+
+    constexpr std::size_t cPagesCount = 535;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto freePages = pageAllocator.getStats().freePagesCount;
+    REQUIRE(pageAllocator.getStats().cachedPagesCount == 0);
+
+    SECTION("Cache is refilled in batches")
+    {
+        auto* page1 = pageAllocator.allocate(1);
+        REQUIRE(page1);
+        auto cachedPagesCount = pageAllocator.getStats().cachedPagesCount;
+        REQUIRE(cachedPagesCount > 0);
+
+        auto* page2 = pageAllocator.allocate(1);
+        REQUIRE(page2);
+        REQUIRE(page2->address() == page1->address() + cPageSize);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == cachedPagesCount - 1);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePages - 2);
+
+        pageAllocator.release(page1);
+        pageAllocator.release(page2);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == cachedPagesCount + 1);
+    }
+
+    SECTION("Cache is refilled from the smallest free group")
+    {
+        auto* first = pageAllocator.allocate(2);
+        auto* hole = pageAllocator.allocate(4);
+        auto* last = pageAllocator.allocate(2);
+        REQUIRE(first);
+        REQUIRE(hole);
+        REQUIRE(last);
+
+        auto holeAddress = hole->address();
+        pageAllocator.release(hole);
+
+        auto* page = pageAllocator.allocate(1);
+        REQUIRE(page);
+        REQUIRE(page->address() == holeAddress);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == 3);
+
+        pageAllocator.release(page);
+        pageAllocator.release(first);
+        pageAllocator.release(last);
+        REQUIRE(pageAllocator.allocate(freePages) != nullptr);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == 0);
+        pageAllocator.reset();
+    }
+
+    SECTION("Cache is drained when it grows too big")
+    {
+        std::vector<Page*> pages;
+        for (std::size_t i = 0; i < freePages; ++i)
+            pages.push_back(pageAllocator.allocate(1));
+
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == 0);
+
+        for (auto* page : pages)
+            pageAllocator.release(page);
+
+        REQUIRE(pageAllocator.getStats().cachedPagesCount < freePages);
+    }
+
+    SECTION("Cache is drained when multiple pages cannot be allocated")
+    {
+        auto* page = pageAllocator.allocate(1);
+        REQUIRE(page);
+        pageAllocator.release(page);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount > 0);
+
+        page = pageAllocator.allocate(freePages);
+        REQUIRE(page);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == 0);
+        pageAllocator.release(page);
+    }
+
+    auto stats = pageAllocator.getStats();
+    REQUIRE(stats.freeMemorySize == (cPageSize * freePages));
+    REQUIRE(stats.freePagesCount == freePages);
+}
+
+TEST_CASE("Pages are correctly reset", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    PageAllocator pageAllocator;
+
+    constexpr std::size_t cPagesCount1 = 535;
+    constexpr std::size_t cPagesCount2 = 87;
+    constexpr std::size_t cPagesCount3 = 4;
+    auto size1 = cPageSize * cPagesCount1;
+    auto size2 = cPageSize * cPagesCount2;
+    auto size3 = cPageSize * cPagesCount3;
+    auto memory1 = test::alignedAlloc(cPageSize, size1);
+    auto memory2 = test::alignedAlloc(cPageSize, size2);
+    auto memory3 = test::alignedAlloc(cPageSize, size3);
+
+    constexpr int cRegionsCount = 4;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory1.get()), size1},
+         {std::uintptr_t(memory2.get()), size2},
+         {std::uintptr_t(memory3.get()), size3},
+         {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto freePages = pageAllocator.getStats().freePagesCount;
+
+    constexpr std::size_t cAllocSize = 17;
+    REQUIRE(pageAllocator.allocate(1));
+    REQUIRE(pageAllocator.allocate(cAllocSize));
+    REQUIRE(pageAllocator.allocate(cPagesCount3));
+    REQUIRE(pageAllocator.getStats().freePagesCount < freePages);
+
+    pageAllocator.reset();
+
+    auto stats = pageAllocator.getStats();
+    REQUIRE(stats.freePagesCount == freePages);
+    REQUIRE(stats.cachedPagesCount == 0);
+    REQUIRE(pageAllocator.allocate(cPagesCount1));
+    REQUIRE(pageAllocator.allocate(cPagesCount3));
+
+    std::vector<Page*> pages;
+    for (std::size_t i = 0; i < freePages - cPagesCount1 - cPagesCount3; ++i) {
+        pages.push_back(pageAllocator.allocate(1));
+        REQUIRE(pages.back());
+    }
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == 0);
+}
+
+TEST_CASE("Pages are correctly resized in place", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto freePages = pageAllocator.getStats().freePagesCount;
+
+    constexpr std::size_t cAllocSize = 4;
+    auto* pages1 = pageAllocator.allocate(cAllocSize);
+    auto* pages2 = pageAllocator.allocate(cAllocSize);
+    REQUIRE(pages1);
+    REQUIRE(pages2);
+    REQUIRE(pages2 == pages1 + cAllocSize);
+
+    SECTION("Resize to 0 pages")
+    {
+        REQUIRE(!pageAllocator.resize(pages1, 0));
+        REQUIRE(pages1->groupSize() == cAllocSize);
+    }
+
+    SECTION("Resize to the same size")
+    {
+        REQUIRE(pageAllocator.resize(pages1, cAllocSize));
+        REQUIRE(pages1->groupSize() == cAllocSize);
+    }
+
+    SECTION("Grow when the following pages are used")
+    {
+        REQUIRE(!pageAllocator.resize(pages1, cAllocSize + 1));
+        REQUIRE(pages1->groupSize() == cAllocSize);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePages - 2 * cAllocSize);
+    }
+
+    SECTION("Grow when the following pages are free")
+    {
+        pageAllocator.release(pages2);
+        constexpr std::size_t cNewSize = 2 * cAllocSize + 2;
+        REQUIRE(pageAllocator.resize(pages1, cNewSize));
+        REQUIRE(pages1->groupSize() == cNewSize);
+        REQUIRE(pages1->isUsed());
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePages - cNewSize);
+        REQUIRE(pageAllocator.allocate(1) == pages1 + cNewSize);
+    }
+
+    SECTION("Grow up to the end of the region")
+    {
+        auto newSize = cAllocSize + pageAllocator.getStats().freePagesCount;
+        REQUIRE(!pageAllocator.resize(pages2, newSize + 1));
+        REQUIRE(pageAllocator.resize(pages2, newSize));
+        REQUIRE(pageAllocator.getStats().freePagesCount == 0);
+    }
+
+    SECTION("Shrink and grow again")
+    {
+        REQUIRE(pageAllocator.resize(pages2, 1));
+        REQUIRE(pages2->groupSize() == 1);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePages - cAllocSize - 1);
+
+        REQUIRE(pageAllocator.resize(pages2, cAllocSize));
+        REQUIRE(pages2->groupSize() == cAllocSize);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePages - 2 * cAllocSize);
+    }
+}
+
+TEST_CASE("Zeroed pages are correctly tracked", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    // Memory is intentionally filled with non-zero pattern to detect if zeroed pages are cleared again.
+    constexpr int cMemsetPattern = 0x5a;
+    std::memset(memory.get(), cMemsetPattern, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    auto isFilledWith = [&](Page* pages, std::size_t count, int value) {
+        auto* bytes = reinterpret_cast<unsigned char*>(pages->address());
+        return std::all_of(bytes, bytes + count * cPageSize, [&](unsigned char byte) { return byte == value; });
+    };
+
+    constexpr std::size_t cAllocSize = 4;
+
+    SECTION("Pages from the regions with unknown content are always cleared")
+    {
+        REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+        auto* pages = pageAllocator.allocateZeroed(cAllocSize);
+        REQUIRE(pages);
+        REQUIRE(isFilledWith(pages, cAllocSize, 0));
+    }
+
+    SECTION("Pages, that were never allocated, are not cleared")
+    {
+        REQUIRE(pageAllocator.init(regions.data(), cPageSize, true));
+
+        auto* pages = pageAllocator.allocateZeroed(cAllocSize);
+        REQUIRE(pages);
+        REQUIRE(isFilledWith(pages, cAllocSize, cMemsetPattern));
+
+        auto* page = pageAllocator.allocateZeroed(1);
+        REQUIRE(page);
+        REQUIRE(isFilledWith(page, 1, cMemsetPattern));
+    }
+
+    SECTION("Released pages are cleared")
+    {
+        REQUIRE(pageAllocator.init(regions.data(), cPageSize, true));
+
+        auto* pages1 = pageAllocator.allocate(cAllocSize);
+        REQUIRE(pages1);
+        pageAllocator.release(pages1);
+
+        auto* pages2 = pageAllocator.allocateZeroed(2 * cAllocSize);
+        REQUIRE(pages2 == pages1);
+        REQUIRE(isFilledWith(pages2, cAllocSize, 0));
+        REQUIRE(isFilledWith(pages2 + cAllocSize, cAllocSize, cMemsetPattern));
+    }
+
+    SECTION("Pages joined by the resize are cleared")
+    {
+        REQUIRE(pageAllocator.init(regions.data(), cPageSize, true));
+
+        auto* pages1 = pageAllocator.allocate(cAllocSize);
+        REQUIRE(pages1);
+        REQUIRE(pageAllocator.resize(pages1, 2 * cAllocSize));
+        pageAllocator.release(pages1);
+
+        auto* pages2 = pageAllocator.allocateZeroed(2 * cAllocSize);
+        REQUIRE(pages2 == pages1);
+        REQUIRE(isFilledWith(pages2, 2 * cAllocSize, 0));
+    }
+
+    SECTION("Pages, that were never allocated, are not cleared after reset")
+    {
+        REQUIRE(pageAllocator.init(regions.data(), cPageSize, true));
+
+        auto* pages1 = pageAllocator.allocate(cAllocSize);
+        REQUIRE(pages1);
+        pageAllocator.reset();
+
+        auto* pages2 = pageAllocator.allocateZeroed(2 * cAllocSize);
+        REQUIRE(pages2 == pages1);
+        REQUIRE(isFilledWith(pages2, cAllocSize, 0));
+        REQUIRE(isFilledWith(pages2 + cAllocSize, cAllocSize, cMemsetPattern));
+    }
+}
+
+/// Represents the page provider, that records the sizes of the obtained regions.
+class RecordingPageProvider : public StaticPageProvider {
+public:
+    using StaticPageProvider::StaticPageProvider;
+
+    Region allocate(std::size_t size) override
+    {
+        auto region = StaticPageProvider::allocate(size);
+        if (region.size != 0)
+            sizes.push_back(size);
+
+        return region;
+    }
+
+    std::vector<std::size_t> sizes; // NOLINT(misc-non-private-member-variables-in-classes)
+};
+
+TEST_CASE("Regions are correctly added after initialization", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount1 = 32;
+    constexpr std::size_t cPagesCount2 = 128;
+    auto size1 = cPageSize * cPagesCount1;
+    auto size2 = cPageSize * cPagesCount2;
+    auto memory1 = test::alignedAlloc(cPageSize, size1);
+    auto memory2 = test::alignedAlloc(cPageSize, size2);
+
+    std::array<Region, 2> regions = {
+        {{std::uintptr_t(memory1.get()), size1}, {0, 0}}
+    };
+
+    PageAllocator pageAllocator;
+    Region region{std::uintptr_t(memory2.get()), size2};
+    REQUIRE(!pageAllocator.addRegion(region));
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto stats = pageAllocator.getStats();
+
+    REQUIRE(pageAllocator.addRegion(region));
+    REQUIRE(!pageAllocator.addRegion(region));
+    REQUIRE(!pageAllocator.addRegion({std::uintptr_t(memory1.get()) + cPageSize, cPageSize}));
+
+    auto descPagesCount = utils::divRoundUp(cPagesCount2 * sizeof(Page), cPageSize);
+    auto newStats = pageAllocator.getStats();
+    REQUIRE(newStats.totalMemorySize == stats.totalMemorySize + size2);
+    REQUIRE(newStats.totalPagesCount == stats.totalPagesCount + cPagesCount2);
+    REQUIRE(newStats.reservedPagesCount == stats.reservedPagesCount + descPagesCount);
+    REQUIRE(newStats.freePagesCount == stats.freePagesCount + cPagesCount2 - descPagesCount);
+
+    // Group bigger than the whole first region has to be taken from the added one.
+    auto* pages = pageAllocator.allocate(cPagesCount2 - descPagesCount);
+    REQUIRE(pages);
+    REQUIRE(pages->address() == std::uintptr_t(memory2.get()) + descPagesCount * cPageSize);
+    REQUIRE(pageAllocator.getPage(pages->address() + cPageSize) == pages + 1);
+
+    pageAllocator.release(pages);
+    REQUIRE(pageAllocator.getStats().freePagesCount == newStats.freePagesCount);
+
+    pageAllocator.reset();
+    REQUIRE(pageAllocator.getStats().freePagesCount == newStats.freePagesCount);
+    REQUIRE(pageAllocator.allocate(cPagesCount2 - descPagesCount));
+}
+
+TEST_CASE("PageAllocator grows with the page provider", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 32;
+    constexpr std::size_t cPoolPagesCount = 1024;
+    auto size = cPageSize * cPagesCount;
+    auto poolSize = cPageSize * cPoolPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto pool = test::alignedAlloc(cPageSize, poolSize);
+    RecordingPageProvider provider(std::uintptr_t(pool.get()), std::uintptr_t(pool.get() + poolSize));
+
+    std::array<Region, 2> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    PageAllocator pageAllocator;
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    auto stats = pageAllocator.getStats();
+
+    SECTION("Allocator without provider does not grow")
+    {
+        REQUIRE(pageAllocator.allocate(stats.freePagesCount));
+        REQUIRE(pageAllocator.allocate(2) == nullptr);
+    }
+
+    SECTION("Regions double in size and are given back when free")
+    {
+        pageAllocator.setProvider(&provider);
+
+        // Groups of 2 pages are used, because single pages could be kept in the page cache.
+        constexpr std::size_t cGroupSize = 2;
+        std::vector<Page*> pages;
+        for (std::size_t i = 0; i < 4 * stats.freePagesCount / cGroupSize; ++i) {
+            pages.push_back(pageAllocator.allocate(cGroupSize));
+            REQUIRE(pages.back());
+        }
+
+        REQUIRE(provider.sizes.size() >= 2);
+        REQUIRE(provider.sizes.front() == size);
+        for (std::size_t i = 1; i < provider.sizes.size(); ++i)
+            REQUIRE(provider.sizes[i] == 2 * provider.sizes[i - 1]);
+
+        for (auto* page : pages)
+            pageAllocator.release(page);
+
+        // First region, that became empty, is kept until trim().
+        REQUIRE(provider.remainingSize() == poolSize - provider.sizes.front());
+        REQUIRE(pageAllocator.trim() != 0);
+        REQUIRE(provider.remainingSize() == poolSize);
+        REQUIRE(pageAllocator.getStats().totalPagesCount == stats.totalPagesCount);
+        REQUIRE(pageAllocator.getStats().freePagesCount == stats.freePagesCount);
+    }
+
+    SECTION("Allocations at the boundary of a provided region do not obtain it again")
+    {
+        pageAllocator.setProvider(&provider);
+        auto* base = pageAllocator.allocate(stats.freePagesCount);
+        REQUIRE(base);
+
+        for (int i = 0; i < 100; ++i) {
+            auto* pages = pageAllocator.allocate(2);
+            REQUIRE(pages);
+            pageAllocator.release(pages);
+        }
+
+        REQUIRE(provider.sizes.size() == 1);
+        REQUIRE(provider.sizes.front() == size);
+
+        pageAllocator.release(base);
+        REQUIRE(pageAllocator.trim() != 0);
+        REQUIRE(provider.remainingSize() == poolSize);
+    }
+
+    SECTION("Regions given back do not keep doubling the size")
+    {
+        pageAllocator.setProvider(&provider);
+        auto* base = pageAllocator.allocate(stats.freePagesCount);
+        REQUIRE(base);
+
+        auto* first = pageAllocator.allocate(2);
+        REQUIRE(first);
+        auto* second = pageAllocator.allocate(cPagesCount - 2);
+        REQUIRE(second);
+        REQUIRE(provider.sizes.size() == 2);
+        REQUIRE(provider.sizes[1] == 2 * provider.sizes[0]);
+
+        // First region is kept empty, so the second one is given back and the next growth has the same size.
+        pageAllocator.release(first);
+        pageAllocator.release(second);
+        REQUIRE(provider.remainingSize() == poolSize - provider.sizes[0]);
+
+        REQUIRE(pageAllocator.allocate(cPagesCount - 2));
+        REQUIRE(provider.sizes.size() == 3);
+        REQUIRE(provider.sizes[2] == provider.sizes[1]);
+    }
+
+    SECTION("Region obtained from the provider restores the used emergency reserve")
+    {
+        constexpr std::size_t cReservePagesCount = 16;
+        constexpr std::size_t cBigPagesCount = 2 * cPagesCount;
+        pageAllocator.setProvider(&provider);
+        pageAllocator.setEmergencyReserve(cReservePagesCount * cPageSize);
+
+        REQUIRE(pageAllocator.allocate(stats.freePagesCount - cReservePagesCount));
+        pageAllocator.setReserveUnlocked(true);
+        REQUIRE(pageAllocator.allocate(cReservePagesCount));
+        pageAllocator.setReserveUnlocked(false);
+        REQUIRE(provider.sizes.empty());
+
+        // Demanded size is bigger than the geometric step, so the region is sized by the demand and the reserve.
+        REQUIRE(pageAllocator.allocate(cBigPagesCount));
+        REQUIRE(provider.sizes.size() == 1);
+        REQUIRE(pageAllocator.getStats().freePagesCount >= cReservePagesCount);
+    }
+
+    SECTION("Demanded size is used when geometric step is not available")
+    {
+        pageAllocator.setProvider(&provider);
+
+        auto* pages = pageAllocator.allocate(cPoolPagesCount / 2);
+        REQUIRE(pages);
+        REQUIRE(provider.sizes.size() == 1);
+        REQUIRE(pageAllocator.allocate(cPoolPagesCount / 4));
+        REQUIRE(provider.sizes.size() == 2);
+        REQUIRE(provider.sizes[1] < 2 * provider.sizes[0]);
+    }
+
+    SECTION("Big allocations are served from dedicated regions")
+    {
+        constexpr std::size_t cDirectPagesCount = 16;
+        pageAllocator.setProvider(&provider, cDirectPagesCount * cPageSize);
+
+        auto* small = pageAllocator.allocate(cDirectPagesCount - 1);
+        REQUIRE(small);
+        REQUIRE(provider.sizes.empty());
+
+        auto* big = pageAllocator.allocate(cDirectPagesCount);
+        REQUIRE(big);
+        REQUIRE(big->groupSize() == cDirectPagesCount);
+        REQUIRE(provider.sizes.size() == 1);
+        REQUIRE(std::uintptr_t(big) >= std::uintptr_t(pool.get()));
+        REQUIRE(std::uintptr_t(big) < std::uintptr_t(pool.get() + poolSize));
+
+        pageAllocator.release(big);
+        REQUIRE(provider.remainingSize() == poolSize);
+        pageAllocator.release(small);
+    }
+
+    SECTION("Requests, that overflow or do not fit into a group, do not obtain regions")
+    {
+        pageAllocator.setProvider(&provider, 4 * cPageSize);
+        constexpr auto cMaxSize = std::numeric_limits<std::size_t>::max();
+        REQUIRE(pageAllocator.allocate(cMaxSize) == nullptr);
+        REQUIRE(pageAllocator.allocate(cMaxSize / cPageSize + 1) == nullptr);
+        REQUIRE(pageAllocator.allocate((std::size_t(1) << 20U) + 1) == nullptr);
+        REQUIRE(pageAllocator.allocateAligned(cMaxSize / cPageSize, 2 * cPageSize) == nullptr);
+        REQUIRE(provider.sizes.empty());
+        REQUIRE(pageAllocator.getStats().totalPagesCount == stats.totalPagesCount);
+    }
+
+    SECTION("Provided regions are given back on demand")
+    {
+        pageAllocator.setProvider(&provider);
+        REQUIRE(pageAllocator.allocate(stats.freePagesCount + 1));
+        REQUIRE(provider.remainingSize() < poolSize);
+
+        pageAllocator.releaseProvidedRegions();
+        REQUIRE(provider.remainingSize() == poolSize);
+        REQUIRE(pageAllocator.getStats().totalPagesCount == 0);
+    }
+}
+
+class MovingPageProvider : public StaticPageProvider {
+public:
+    using StaticPageProvider::StaticPageProvider;
+
+    bool move(const Region& from, std::uintptr_t to) override
+    {
+        if (!movable)
+            return false;
+
+        std::memmove(reinterpret_cast<void*>(to), reinterpret_cast<void*>(from.address), from.size);
+        movedSize += from.size;
+        return true;
+    }
+
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::size_t movedSize{};
+    bool movable{true};
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+TEST_CASE("Direct allocations are moved by the page provider", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 32;
+    constexpr std::size_t cPoolPagesCount = 1024;
+    constexpr std::size_t cDirectPagesCount = 16;
+    auto size = cPageSize * cPagesCount;
+    auto poolSize = cPageSize * cPoolPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    auto pool = test::alignedAlloc(cPageSize, poolSize);
+    MovingPageProvider provider(std::uintptr_t(pool.get()), std::uintptr_t(pool.get() + poolSize));
+
+    std::array<Region, 2> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    PageAllocator pageAllocator;
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+    pageAllocator.setProvider(&provider, cDirectPagesCount * cPageSize);
+    auto stats = pageAllocator.getStats();
+
+    auto fill = [](Page* pages, std::size_t count) {
+        auto* bytes = reinterpret_cast<std::uint8_t*>(pages->address());
+        for (std::size_t i = 0; i < count * cPageSize; ++i)
+            bytes[i] = static_cast<std::uint8_t>(i % 251); // NOLINT
+    };
+
+    auto isFilled = [](Page* pages, std::size_t count) {
+        auto* bytes = reinterpret_cast<std::uint8_t*>(pages->address());
+        for (std::size_t i = 0; i < count * cPageSize; ++i) {
+            if (bytes[i] != static_cast<std::uint8_t>(i % 251)) // NOLINT
+                return false;
+        }
+
+        return true;
+    };
+
+    SECTION("Pages outside of dedicated regions are not moved")
+    {
+        auto* pages = pageAllocator.allocate(4);
+        REQUIRE(pages);
+        REQUIRE(pageAllocator.remap(pages, 2 * cDirectPagesCount) == nullptr);
+
+        auto* big = pageAllocator.allocate(cDirectPagesCount);
+        REQUIRE(big);
+        REQUIRE(pageAllocator.remap(big, cDirectPagesCount / 2) == nullptr);
+        REQUIRE(provider.movedSize == 0);
+
+        pageAllocator.release(big);
+        pageAllocator.release(pages);
+    }
+
+    SECTION("Dedicated region is moved together with its content")
+    {
+        constexpr std::size_t cMovedPagesCount = 4 * cDirectPagesCount;
+        auto* big = pageAllocator.allocate(cDirectPagesCount);
+        REQUIRE(big);
+        auto bigPagesCount = big->groupSize();
+        fill(big, cDirectPagesCount);
+
+        auto* moved = pageAllocator.remap(big, cMovedPagesCount);
+        REQUIRE(moved);
+        REQUIRE(moved->groupSize() >= cMovedPagesCount);
+        REQUIRE(provider.movedSize == bigPagesCount * cPageSize);
+        REQUIRE(isFilled(moved, cDirectPagesCount));
+        REQUIRE(pageAllocator.getPage(moved->address() + cMovedPagesCount * cPageSize - 1) != nullptr);
+
+        auto* shrunk = pageAllocator.remap(moved, cDirectPagesCount);
+        REQUIRE(shrunk);
+        REQUIRE(isFilled(shrunk, cDirectPagesCount));
+
+        pageAllocator.release(shrunk);
+        REQUIRE(provider.remainingSize() == poolSize);
+        REQUIRE(pageAllocator.getStats().totalPagesCount == stats.totalPagesCount);
+    }
+
+    SECTION("Pages are left untouched, when provider cannot move them")
+    {
+        provider.movable = false;
+
+        auto* big = pageAllocator.allocate(cDirectPagesCount);
+        REQUIRE(big);
+        fill(big, cDirectPagesCount);
+        auto remainingSize = provider.remainingSize();
+
+        REQUIRE(pageAllocator.remap(big, 4 * cDirectPagesCount) == nullptr);
+        REQUIRE(provider.remainingSize() == remainingSize);
+        REQUIRE(pageAllocator.getPage(big->address()) == big);
+        REQUIRE(isFilled(big, cDirectPagesCount));
+
+        pageAllocator.release(big);
+        REQUIRE(provider.remainingSize() == poolSize);
+    }
+}
+
+class DecommittingPageProvider : public StaticPageProvider {
+public:
+    using StaticPageProvider::StaticPageProvider;
+
+    bool decommit(const Region& region) override
+    {
+        decommits.push_back(region);
+        if (!accepted)
+            return false;
+
+        // Behaves like MADV_DONTNEED, after which the anonymous memory reads as zeros.
+        std::memset(reinterpret_cast<void*>(region.address), 0, region.size);
+        return true;
+    }
+
+    void commit(const Region& region) override { commits.push_back(region); }
+
+    [[nodiscard]] std::size_t decommitAlignment() const override { return alignment; }
+
+    [[nodiscard]] bool isZeroedAfterDecommit() const override { return true; }
+
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::vector<Region> decommits;
+    std::vector<Region> commits;
+    bool accepted{true};
+    std::size_t alignment{};
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+TEST_CASE("Free pages are decommitted through the page provider", "[unit][PageAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 64;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    DecommittingPageProvider provider(0, 0);
+    auto decommittedSize = [&provider] {
+        std::size_t decommitted = 0;
+        for (const auto& range : provider.decommits)
+            decommitted += range.size;
+
+        return decommitted;
+    };
+
+    std::array<Region, 2> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    PageAllocator pageAllocator;
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize, true));
+    auto stats = pageAllocator.getStats();
+
+    SECTION("Trim without provider does nothing")
+    {
+        REQUIRE(pageAllocator.trim() == 0);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == 0);
+    }
+
+    SECTION("Trim decommits all free pages once")
+    {
+        pageAllocator.setProvider(&provider);
+
+        auto* single = pageAllocator.allocate(1);
+        auto* group = pageAllocator.allocate(4);
+        REQUIRE(single);
+        REQUIRE(group);
+        pageAllocator.release(single);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount != 0);
+
+        auto freePagesCount = pageAllocator.getStats().freePagesCount;
+        REQUIRE(pageAllocator.trim() == freePagesCount * cPageSize);
+        REQUIRE(decommittedSize() == freePagesCount * cPageSize);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == freePagesCount);
+        REQUIRE(pageAllocator.getStats().cachedPagesCount == 0);
+        auto groupEnd = group->address() + 4 * cPageSize;
+        for (const auto& range : provider.decommits)
+            REQUIRE((range.address >= groupEnd || range.address + range.size <= group->address()));
+
+        provider.decommits.clear();
+        REQUIRE(pageAllocator.trim() == 0);
+        REQUIRE(provider.decommits.empty());
+
+        // Released group is the only committed free memory, so only it is decommitted.
+        pageAllocator.release(group);
+        REQUIRE(pageAllocator.trim() == 4 * cPageSize);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == stats.freePagesCount);
+    }
+
+    SECTION("Decommitted pages are committed again only when allocated")
+    {
+        pageAllocator.setProvider(&provider);
+        REQUIRE(pageAllocator.trim() == stats.freePagesCount * cPageSize);
+
+        auto* pages = pageAllocator.allocate(4);
+        REQUIRE(pages);
+        REQUIRE(provider.commits.size() == 1);
+        REQUIRE(provider.commits.front().address == pages->address());
+        REQUIRE(provider.commits.front().size == 4 * cPageSize);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == stats.freePagesCount - 4);
+
+        REQUIRE(pageAllocator.resize(pages, 6));
+        REQUIRE(provider.commits.size() == 2);
+        REQUIRE(provider.commits.back().address == pages->address() + 4 * cPageSize);
+        REQUIRE(provider.commits.back().size == 2 * cPageSize);
+
+        pageAllocator.release(pages);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == stats.freePagesCount - 6);
+        REQUIRE(pageAllocator.trim() == 6 * cPageSize);
+    }
+
+    SECTION("Decommitted pages are not cleared again")
+    {
+        pageAllocator.setProvider(&provider);
+
+        auto* pages = pageAllocator.allocate(stats.freePagesCount);
+        REQUIRE(pages);
+        std::memset(reinterpret_cast<void*>(pages->address()), 0xaa, stats.freePagesCount * cPageSize);
+        pageAllocator.release(pages);
+        REQUIRE(pageAllocator.trim() == stats.freePagesCount * cPageSize);
+
+        pages = pageAllocator.allocateZeroed(stats.freePagesCount);
+        REQUIRE(pages);
+        auto* bytes = reinterpret_cast<std::uint8_t*>(pages->address());
+        REQUIRE(std::all_of(bytes, bytes + stats.freePagesCount * cPageSize, [](auto value) { return value == 0; }));
+    }
+
+    SECTION("Decommitted ranges are aligned as demanded by the provider")
+    {
+        constexpr std::size_t cAlignment = 4 * cPageSize;
+        pageAllocator.setProvider(&provider);
+        provider.alignment = cAlignment;
+
+        // Allocated pages break the free memory into runs, that do not start and end at the aligned addresses.
+        auto* first = pageAllocator.allocate(3);
+        auto* second = pageAllocator.allocate(3);
+        REQUIRE(first);
+        REQUIRE(second);
+        pageAllocator.release(first);
+
+        auto decommitted = pageAllocator.trim();
+        REQUIRE(decommitted != 0);
+        REQUIRE(decommitted == decommittedSize());
+        REQUIRE(decommitted < (stats.freePagesCount - 3) * cPageSize);
+        auto secondEnd = second->address() + 3 * cPageSize;
+        for (const auto& range : provider.decommits) {
+            REQUIRE(range.address % cAlignment == 0);
+            REQUIRE(range.size % cAlignment == 0);
+            REQUIRE((range.address >= secondEnd || range.address + range.size <= second->address()));
+        }
+
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount * cPageSize == decommitted);
+        pageAllocator.release(second);
+    }
+
+    SECTION("Release above the threshold decommits free pages")
+    {
+        constexpr std::size_t cThresholdPagesCount = 8;
+        pageAllocator.setProvider(&provider);
+        pageAllocator.setDecommitThreshold(cThresholdPagesCount * cPageSize);
+
+        auto* pages = pageAllocator.allocate(4);
+        REQUIRE(pages);
+        REQUIRE(provider.decommits.empty());
+
+        pageAllocator.release(pages);
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == stats.freePagesCount);
+
+        // Free committed memory has to grow above the threshold again, before the next decommit.
+        std::vector<Page*> groups;
+        for (std::size_t i = 0; i < 4; ++i) {
+            groups.push_back(pageAllocator.allocate(2));
+            REQUIRE(groups.back());
+        }
+
+        provider.decommits.clear();
+        for (std::size_t i = 0; i < groups.size() - 1; ++i)
+            pageAllocator.release(groups[i]);
+
+        REQUIRE(provider.decommits.empty());
+        pageAllocator.release(groups.back());
+        REQUIRE(decommittedSize() == cThresholdPagesCount * cPageSize);
+    }
+
+    SECTION("Pages refused by the provider do not trigger decommit on every release")
+    {
+        pageAllocator.setProvider(&provider);
+        pageAllocator.setDecommitThreshold(cPageSize);
+        provider.accepted = false;
+
+        auto* pages = pageAllocator.allocate(4);
+        REQUIRE(pages);
+        pageAllocator.release(pages);
+        REQUIRE(!provider.decommits.empty());
+        REQUIRE(pageAllocator.getStats().decommittedPagesCount == 0);
+
+        provider.decommits.clear();
+        pages = pageAllocator.allocate(4);
+        REQUIRE(pages);
+        pageAllocator.release(pages);
+        REQUIRE(provider.decommits.empty());
+    }
+}
+
 } // namespace memory
@@ -0,0 +1,231 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+#include <TestUtils.hpp>
+#include <allocator/PageProvider.hpp>
+#ifdef __linux__
+#include <allocator/MmapPageProvider.hpp>
+
+#include <unistd.h>
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#ifdef __linux__
+#include <fstream>
+#include <iterator>
+#include <string>
+#endif
+
+namespace memory {
+
+TEST_CASE("StaticPageProvider carves regions out of the pool", "[unit][PageProvider]")
+{
+    constexpr std::size_t cPoolSize = 4096;
+    constexpr std::size_t cRegionSize = 1024;
+    auto pool = test::alignedAlloc(cRegionSize, cPoolSize);
+    auto start = std::uintptr_t(pool.get());
+    StaticPageProvider provider(start, start + cPoolSize);
+    REQUIRE(!provider.isZeroed());
+    REQUIRE(provider.remainingSize() == cPoolSize);
+
+    SECTION("Regions are handed out in order until the pool is exhausted")
+    {
+        REQUIRE(provider.allocate(0).size == 0);
+
+        for (std::size_t i = 0; i < cPoolSize / cRegionSize; ++i) {
+            auto region = provider.allocate(cRegionSize);
+            REQUIRE(region.address == start + i * cRegionSize);
+            REQUIRE(region.size == cRegionSize);
+        }
+
+        REQUIRE(provider.remainingSize() == 0);
+        REQUIRE(provider.allocate(1).size == 0);
+    }
+
+    SECTION("Released regions are reused and merged back into the pool")
+    {
+        auto region1 = provider.allocate(cRegionSize);
+        auto region2 = provider.allocate(cRegionSize);
+        REQUIRE(provider.remainingSize() == cPoolSize - 2 * cRegionSize);
+
+        provider.release(region1);
+        REQUIRE(provider.remainingSize() == cPoolSize - 2 * cRegionSize);
+
+        auto region3 = provider.allocate(cRegionSize / 2);
+        REQUIRE(region3.address == region1.address);
+        REQUIRE(region3.size == cRegionSize);
+
+        provider.release(region2);
+        REQUIRE(provider.remainingSize() == cPoolSize - cRegionSize);
+
+        provider.release(region3);
+        REQUIRE(provider.remainingSize() == cPoolSize);
+    }
+
+    SECTION("Too big regions are not handed out")
+    {
+        REQUIRE(provider.allocate(cPoolSize + 1).size == 0);
+        REQUIRE(provider.allocate(cPoolSize).size == cPoolSize);
+    }
+}
+
+#ifdef __linux__
+namespace {
+
+/// Checks, if the system can back the regions with huge pages.
+/// @return Flag indicating if the reserved pool of huge pages is not empty or transparent huge pages are enabled.
+bool isHugePageAvailable()
+{
+    std::ifstream meminfo("/proc/meminfo");
+    for (std::string key; meminfo >> key;) {
+        std::size_t value = 0;
+        if (key == "HugePages_Free:" && meminfo >> value && value != 0)
+            return true;
+    }
+
+    std::ifstream thp("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode((std::istreambuf_iterator<char>(thp)), std::istreambuf_iterator<char>());
+    return (!mode.empty() && mode.find("[never]") == std::string::npos);
+}
+
+} // namespace
+
+TEST_CASE("MmapPageProvider maps zeroed regions", "[unit][PageProvider]")
+{
+    constexpr std::size_t cRegionSize = 64 * 1024;
+    MmapPageProvider provider;
+    REQUIRE(provider.isZeroed());
+    REQUIRE(provider.allocate(0).size == 0);
+
+    auto region = provider.allocate(cRegionSize);
+    REQUIRE(region.address != 0);
+    REQUIRE(region.size == cRegionSize);
+
+    auto* bytes = reinterpret_cast<std::byte*>(region.address);
+    REQUIRE(std::all_of(bytes, bytes + cRegionSize, [](std::byte value) { return value == std::byte{0}; }));
+    std::memset(bytes, 1, cRegionSize);
+
+    provider.release(region);
+}
+
+TEST_CASE("MmapPageProvider decommits ranges", "[unit][PageProvider]")
+{
+    auto systemPageSize = static_cast<std::size_t>(getpagesize());
+    auto regionSize = 16 * systemPageSize;
+    MmapPageProvider provider;
+    REQUIRE(provider.isZeroedAfterDecommit());
+    REQUIRE(!MmapPageProvider(true).isZeroedAfterDecommit());
+
+    auto region = provider.allocate(regionSize);
+    REQUIRE(region.size == regionSize);
+    auto* bytes = reinterpret_cast<std::byte*>(region.address);
+    std::memset(bytes, 1, regionSize);
+
+    // Ranges smaller than the system page would drop the content of their neighbours.
+    REQUIRE(!provider.decommit({region.address + systemPageSize / 2, systemPageSize}));
+    REQUIRE(!provider.decommit({region.address, systemPageSize / 2}));
+    REQUIRE(bytes[0] == std::byte{1});
+
+    REQUIRE(provider.decommit({region.address + systemPageSize, 2 * systemPageSize}));
+    provider.commit({region.address + systemPageSize, 2 * systemPageSize});
+    REQUIRE(bytes[systemPageSize - 1] == std::byte{1});
+    REQUIRE(std::all_of(bytes + systemPageSize, bytes + 3 * systemPageSize, [](std::byte value) {
+        return value == std::byte{0};
+    }));
+    REQUIRE(bytes[3 * systemPageSize] == std::byte{1});
+
+    provider.release(region);
+}
+
+TEST_CASE("MmapPageProvider moves ranges between regions", "[unit][PageProvider]")
+{
+    auto systemPageSize = static_cast<std::size_t>(getpagesize());
+    auto regionSize = 4 * systemPageSize;
+    MmapPageProvider provider;
+
+    auto from = provider.allocate(regionSize);
+    auto to = provider.allocate(regionSize);
+    REQUIRE(from.size == regionSize);
+    REQUIRE(to.size == regionSize);
+    std::memset(reinterpret_cast<void*>(from.address), 1, regionSize);
+
+    REQUIRE(!provider.move({from.address + 1, systemPageSize}, to.address));
+    REQUIRE(!provider.move({from.address, systemPageSize}, to.address + 1));
+    REQUIRE(provider.move({from.address, 2 * systemPageSize}, to.address + systemPageSize));
+
+    auto* bytes = reinterpret_cast<std::byte*>(to.address);
+    REQUIRE(bytes[systemPageSize - 1] == std::byte{0});
+    REQUIRE(std::all_of(bytes + systemPageSize, bytes + 3 * systemPageSize, [](std::byte value) {
+        return value == std::byte{1};
+    }));
+    REQUIRE(bytes[3 * systemPageSize] == std::byte{0});
+
+    provider.release(from);
+    provider.release(to);
+}
+
+TEST_CASE("MmapPageProvider maps huge page aligned regions", "[unit][PageProvider][hugepages]")
+{
+    // Decommit semantics checked below hold only for the memory backed by hugetlbfs or transparent huge pages.
+    if (!isHugePageAvailable()) {
+        WARN("Huge pages are not available, skipping");
+        return;
+    }
+
+    constexpr auto cHugePageSize = MmapPageProvider::hugePageSize();
+    MmapPageProvider provider(false, true);
+    REQUIRE(provider.decommitAlignment() == cHugePageSize);
+
+    auto region = provider.allocate(cHugePageSize + 1);
+    REQUIRE(region.address % cHugePageSize == 0);
+    REQUIRE(region.size == 2 * cHugePageSize);
+
+    auto* bytes = reinterpret_cast<std::byte*>(region.address);
+    REQUIRE(std::all_of(bytes, bytes + region.size, [](std::byte value) { return value == std::byte{0}; }));
+    std::memset(bytes, 1, region.size);
+
+    // Decommit of the range smaller than the huge page would split it.
+    auto systemPageSize = static_cast<std::size_t>(getpagesize());
+    REQUIRE(!provider.decommit({region.address, systemPageSize}));
+    REQUIRE(provider.decommit({region.address + cHugePageSize, cHugePageSize}));
+    REQUIRE(bytes[cHugePageSize - 1] == std::byte{1});
+    REQUIRE(bytes[cHugePageSize] == std::byte{0});
+
+    provider.release(region);
+}
+#endif
+
+} // namespace memory
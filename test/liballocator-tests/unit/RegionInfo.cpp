@@ -58,6 +58,8 @@ TEST_CASE("RegionInfo structure is properly cleared", "[unit][RegionInfo]")
     REQUIRE(regionInfo.alignedSize == 0);
     REQUIRE(regionInfo.firstPage == nullptr);
     REQUIRE(regionInfo.lastPage == nullptr);
+    REQUIRE(regionInfo.descPagesCount == 0);
+    REQUIRE(!regionInfo.provided);
 }
 
 TEST_CASE("Aligned start address is properly computed", "[unit][RegionInfo]")
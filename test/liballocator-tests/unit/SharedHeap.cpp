@@ -0,0 +1,415 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/SharedHeap.hpp>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdlib>
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("SharedHeap is created and attached", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 64 * 1024;
+    auto memory = test::alignedAlloc(alignof(std::max_align_t), cSize);
+    std::memset(memory.get(), 0, cSize);
+
+    SECTION("Memory without the heap is not attached")
+    {
+        REQUIRE(SharedHeap::attach(memory.get(), cSize) == nullptr);
+        REQUIRE(SharedHeap::attach(nullptr, cSize) == nullptr);
+    }
+
+    SECTION("Invalid memory is rejected")
+    {
+        REQUIRE(SharedHeap::create(nullptr, cSize) == nullptr);
+        REQUIRE(SharedHeap::create(memory.get() + 1, cSize - 1) == nullptr);
+        REQUIRE(SharedHeap::create(memory.get(), sizeof(SharedHeap)) == nullptr);
+    }
+
+    SECTION("Created heap is attached")
+    {
+        auto* heap = SharedHeap::create(memory.get(), cSize);
+        REQUIRE(heap);
+        REQUIRE(SharedHeap::attach(memory.get(), cSize) == heap);
+
+        auto stats = heap->getStats();
+        REQUIRE(stats.totalMemorySize == cSize);
+        REQUIRE(stats.reservedMemorySize + stats.userMemorySize == cSize);
+        REQUIRE(stats.freeMemorySize == stats.userMemorySize);
+        REQUIRE(stats.allocatedMemorySize == 0);
+    }
+
+    SECTION("Heap bigger than the mapping is rejected")
+    {
+        REQUIRE(SharedHeap::create(memory.get(), cSize));
+        REQUIRE(SharedHeap::attach(memory.get(), cSize - alignof(std::max_align_t)) == nullptr);
+        REQUIRE(SharedHeap::attach(memory.get(), sizeof(SharedHeap) - 1) == nullptr);
+        REQUIRE(SharedHeap::recover(memory.get(), cSize / 2) == nullptr);
+        REQUIRE(SharedHeap::attach(memory.get(), cSize));
+    }
+}
+
+TEST_CASE("SharedHeap properly allocates and releases memory", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 256 * 1024;
+    auto memory = test::alignedAlloc(alignof(std::max_align_t), cSize);
+    auto* heap = SharedHeap::create(memory.get(), cSize);
+    REQUIRE(heap);
+    auto userMemorySize = heap->getStats().userMemorySize;
+
+    SECTION("Allocate 0 bytes")
+    {
+        REQUIRE(heap->allocate(0) == nullptr);
+    }
+
+    SECTION("Allocate more than available")
+    {
+        REQUIRE(heap->allocate(cSize) == nullptr);
+        REQUIRE(heap->getStats().freeMemorySize == userMemorySize);
+    }
+
+    SECTION("Allocations are aligned, disjoint and released")
+    {
+        std::vector<std::byte*> ptrs;
+        for (std::size_t i = 1; i < 200; ++i) {
+            auto* ptr = static_cast<std::byte*>(heap->allocate(i * 7));
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignof(std::max_align_t) == 0);
+            REQUIRE(heap->usableSize(ptr) >= i * 7);
+            std::memset(ptr, int(i), heap->usableSize(ptr));
+            ptrs.push_back(ptr);
+        }
+
+        for (std::size_t i = 0; i < ptrs.size(); ++i) {
+            for (std::size_t j = 0; j < heap->usableSize(ptrs[i]); ++j)
+                REQUIRE(ptrs[i][j] == std::byte(i + 1));
+        }
+
+        REQUIRE(heap->getStats().allocatedMemorySize > 0);
+
+        // Every second block is released first, so that the remaining ones are coalesced from both sides.
+        for (std::size_t i = 0; i < ptrs.size(); i += 2)
+            heap->release(ptrs[i]);
+
+        for (std::size_t i = 1; i < ptrs.size(); i += 2)
+            heap->release(ptrs[i]);
+
+        REQUIRE(heap->getStats().freeMemorySize == userMemorySize);
+    }
+
+    SECTION("Whole memory is available again after release")
+    {
+        auto* ptr1 = heap->allocate(userMemorySize / 2);
+        auto* ptr2 = heap->allocate(userMemorySize / 4);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(heap->allocate(userMemorySize / 2) == nullptr);
+
+        heap->release(ptr1);
+        heap->release(ptr2);
+        REQUIRE(heap->allocate(userMemorySize - 64));
+    }
+}
+
+TEST_CASE("SharedHeap is independent of the mapping address", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 64 * 1024;
+    constexpr std::size_t cBlocksCount = 32;
+    auto memory1 = test::alignedAlloc(alignof(std::max_align_t), cSize);
+    auto memory2 = test::alignedAlloc(alignof(std::max_align_t), cSize);
+
+    // Blocks are chained through offsets, so that the chain survives moving the heap to another address.
+    auto* heap1 = SharedHeap::create(memory1.get(), cSize);
+    REQUIRE(heap1);
+    SharedHeap::Offset head = 0;
+    for (std::size_t i = 0; i < cBlocksCount; ++i) {
+        auto* node = static_cast<SharedHeap::Offset*>(heap1->allocate(2 * sizeof(SharedHeap::Offset)));
+        REQUIRE(node);
+        node[0] = head;
+        node[1] = i;
+        head = heap1->toOffset(node);
+    }
+
+    auto stats = heap1->getStats();
+    std::memcpy(memory2.get(), memory1.get(), cSize);
+    auto* heap2 = SharedHeap::attach(memory2.get(), cSize);
+    REQUIRE(heap2);
+    REQUIRE(heap2->getStats().freeMemorySize == stats.freeMemorySize);
+
+    for (std::size_t i = cBlocksCount; i > 0; --i) {
+        auto* node = static_cast<SharedHeap::Offset*>(heap2->fromOffset(head));
+        REQUIRE(node);
+        REQUIRE(node[1] == i - 1);
+        head = node[0];
+        heap2->release(node);
+    }
+
+    REQUIRE(head == 0);
+    REQUIRE(heap2->fromOffset(head) == nullptr);
+    REQUIRE(heap2->getStats().allocatedMemorySize == 0);
+}
+
+TEST_CASE("SharedHeap is recovered after processes exit", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 64 * 1024;
+    constexpr std::size_t cNodesCount = 16;
+    auto memory = test::alignedAlloc(alignof(std::max_align_t), cSize);
+    auto* heap = SharedHeap::create(memory.get(), cSize);
+    REQUIRE(heap);
+    REQUIRE(heap->attachedCount() == 1);
+    REQUIRE(heap->root() == 0);
+
+    std::vector<SharedHeap::Offset*> nodes;
+    SharedHeap::Offset head = 0;
+    for (std::size_t i = 0; i < 2 * cNodesCount; ++i) {
+        auto* node = static_cast<SharedHeap::Offset*>(heap->allocate(2 * sizeof(SharedHeap::Offset)));
+        REQUIRE(node);
+        nodes.push_back(node);
+    }
+
+    // Every second node is released, so that the recovery has to rebuild fragmented free lists.
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (i % 2 == 0) {
+            heap->release(nodes[i]);
+            continue;
+        }
+
+        nodes[i][0] = head;
+        nodes[i][1] = i;
+        head = heap->toOffset(nodes[i]);
+    }
+
+    heap->setRoot(head);
+    auto stats = heap->getStats();
+
+    SECTION("Cleanly detached heap is attached as it is")
+    {
+        heap->detach();
+        REQUIRE(heap->attachedCount() == 0);
+
+        heap = SharedHeap::recover(memory.get(), cSize);
+        REQUIRE(heap);
+        REQUIRE(heap->attachedCount() == 1);
+        REQUIRE(heap->getStats().freeMemorySize == stats.freeMemorySize);
+    }
+
+    SECTION("Heap left without detaching is rebuilt")
+    {
+        heap = SharedHeap::recover(memory.get(), cSize);
+        REQUIRE(heap);
+        REQUIRE(heap->attachedCount() == 1);
+        REQUIRE(heap->getStats().freeMemorySize == stats.freeMemorySize);
+
+        std::size_t count = 0;
+        for (auto offset = heap->root(); offset != 0; ++count) {
+            auto* node = static_cast<SharedHeap::Offset*>(heap->fromOffset(offset));
+            REQUIRE(node[1] == 2 * (cNodesCount - count) - 1);
+            offset = node[0];
+            heap->release(node);
+        }
+
+        REQUIRE(count == cNodesCount);
+        REQUIRE(heap->getStats().allocatedMemorySize == 0);
+        REQUIRE(heap->allocate(heap->getStats().userMemorySize - 64));
+    }
+
+    SECTION("Heap with corrupted blocks is not recovered")
+    {
+        std::memset(nodes[1] - 2, 0xff, 2 * sizeof(SharedHeap::Offset));
+        REQUIRE(SharedHeap::recover(memory.get(), cSize) == nullptr);
+    }
+}
+
+#ifdef __linux__
+TEST_CASE("SharedHeap is shared between processes", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 1024 * 1024;
+    constexpr int cIterations = 20000;
+
+    // The same memory is mapped twice, so that each process uses the heap at a different address.
+    int fd = memfd_create("liballocator-shared-heap", 0);
+    REQUIRE(fd >= 0);
+    REQUIRE(ftruncate(fd, cSize) == 0);
+    auto* memory1 = mmap(nullptr, cSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto* memory2 = mmap(nullptr, cSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    REQUIRE(memory1 != MAP_FAILED);
+    REQUIRE(memory2 != MAP_FAILED);
+    REQUIRE(memory1 != memory2);
+
+    auto* heap = SharedHeap::create(memory1, cSize);
+    REQUIRE(heap);
+    auto userMemorySize = heap->getStats().userMemorySize;
+
+    SECTION("Block allocated through one mapping is released through the other")
+    {
+        auto* ptr = heap->allocate(100);
+        REQUIRE(ptr);
+        std::memset(ptr, 0x5a, 100);
+
+        auto* other = SharedHeap::attach(memory2, cSize);
+        REQUIRE(other);
+        auto* otherPtr = static_cast<unsigned char*>(other->fromOffset(heap->toOffset(ptr)));
+        REQUIRE(otherPtr != ptr);
+        REQUIRE(otherPtr[99] == 0x5a);
+
+        other->release(otherPtr);
+        REQUIRE(heap->getStats().freeMemorySize == userMemorySize);
+    }
+
+    SECTION("Concurrent processes allocate and release blocks")
+    {
+        auto worker = [](SharedHeap* shared, unsigned char pattern) {
+            for (int i = 0; i < cIterations; ++i) {
+                auto size = std::size_t(16 + (i * 37) % 2000);
+                auto* ptr = static_cast<unsigned char*>(shared->allocate(size));
+                if (ptr == nullptr)
+                    return false;
+
+                std::memset(ptr, pattern, size);
+                bool valid = (ptr[0] == pattern && ptr[size - 1] == pattern);
+                shared->release(ptr);
+                if (!valid)
+                    return false;
+            }
+
+            return true;
+        };
+
+        auto pid = fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0)
+            _exit(worker(SharedHeap::attach(memory2, cSize), 0xc3) ? 0 : 1);
+
+        bool valid = worker(heap, 0x3c);
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+        REQUIRE(valid);
+        REQUIRE(heap->getStats().freeMemorySize == userMemorySize);
+    }
+
+    munmap(memory1, cSize);
+    munmap(memory2, cSize);
+}
+
+TEST_CASE("SharedHeap persists in a memory-mapped file", "[unit][SharedHeap]")
+{
+    constexpr std::size_t cSize = 1024 * 1024;
+    constexpr std::size_t cNodesCount = 1000;
+
+    std::array<char, 32> path{"/tmp/liballocator-heap-XXXXXX"};
+    int fd = mkstemp(path.data());
+    REQUIRE(fd >= 0);
+    unlink(path.data());
+    REQUIRE(ftruncate(fd, cSize) == 0);
+
+    // Child builds the objects and is killed in the middle of allocations, without detaching from the heap.
+    std::array<int, 2> ready{};
+    REQUIRE(pipe(ready.data()) == 0);
+    auto pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        close(ready[0]);
+        auto* memory = mmap(nullptr, cSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto* heap = SharedHeap::create(memory, cSize);
+        if (heap == nullptr)
+            _exit(1);
+
+        SharedHeap::Offset head = 0;
+        for (std::size_t i = 0; i < cNodesCount; ++i) {
+            auto* node = static_cast<SharedHeap::Offset*>(heap->allocate(2 * sizeof(SharedHeap::Offset)));
+            node[0] = head;
+            node[1] = i;
+            head = heap->toOffset(node);
+        }
+
+        heap->setRoot(head);
+        for (std::size_t i = 0;; ++i) {
+            heap->release(heap->allocate(16 + i % 4096));
+
+            // Parent is notified only once the loop is running, so the kill always lands among the operations.
+            if (i == 0 && write(ready[1], "r", 1) != 1)
+                _exit(1);
+        }
+    }
+
+    close(ready[1]);
+    char byte{};
+    REQUIRE(read(ready[0], &byte, 1) == 1);
+    close(ready[0]);
+    REQUIRE(kill(pid, SIGKILL) == 0);
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFSIGNALED(status));
+
+    auto* memory = mmap(nullptr, cSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    REQUIRE(memory != MAP_FAILED);
+
+    auto* heap = SharedHeap::recover(memory, cSize);
+    REQUIRE(heap);
+    REQUIRE(heap->root() != 0);
+
+    std::size_t count = 0;
+    for (auto offset = heap->root(); offset != 0; ++count) {
+        auto* node = static_cast<SharedHeap::Offset*>(heap->fromOffset(offset));
+        REQUIRE(node[1] == cNodesCount - count - 1);
+        offset = node[0];
+    }
+
+    REQUIRE(count == cNodesCount);
+    REQUIRE(heap->allocate(4096));
+    heap->detach();
+    REQUIRE(heap->attachedCount() == 0);
+    munmap(memory, cSize);
+}
+#endif
+
+} // namespace memory
@@ -0,0 +1,227 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/Heap.hpp>
+#include <allocator/SignalSafePool.hpp>
+
+#ifdef __linux__
+#include <sys/time.h>
+
+#include <csignal>
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace memory {
+
+TEST_CASE("SignalSafePool allocates from pre-reserved blocks", "[unit][SignalSafePool]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 64;
+    constexpr std::size_t cMaxSize = 256;
+    constexpr std::size_t cBlocksCount = 8;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    SignalSafePool pool(heap);
+    REQUIRE(pool.availableCount(16) == 0);
+    REQUIRE(pool.allocate(16) == nullptr);
+
+    SECTION("Invalid parameters are rejected")
+    {
+        REQUIRE(!pool.init(0, cBlocksCount));
+        REQUIRE(!pool.init(cMaxSize, 0));
+        REQUIRE(!pool.init(2 * cPageSize, cBlocksCount));
+    }
+
+    SECTION("Pools are filled during initialization")
+    {
+        REQUIRE(pool.init(cMaxSize, cBlocksCount));
+        for (std::size_t allocSize = 1; allocSize <= cMaxSize; allocSize *= 2)
+            REQUIRE(pool.availableCount(allocSize) == cBlocksCount);
+
+        REQUIRE(pool.availableCount(cMaxSize + 1) == 0);
+        REQUIRE(pool.allocate(cMaxSize + 1) == nullptr);
+        REQUIRE(pool.allocate(0) == nullptr);
+        REQUIRE(heap.getStats().freeMemorySize < freeMemorySize);
+    }
+
+    SECTION("Pool is emptied by allocations and refilled lazily")
+    {
+        constexpr std::size_t cAllocSize = 100;
+        REQUIRE(pool.init(cMaxSize, cBlocksCount));
+
+        std::array<void*, cBlocksCount> ptrs{};
+        for (std::size_t i = 0; i < cBlocksCount; ++i) {
+            ptrs[i] = pool.allocate(cAllocSize);
+            REQUIRE(ptrs[i]);
+            std::memset(ptrs[i], int(i), cAllocSize);
+        }
+
+        REQUIRE(pool.availableCount(cAllocSize) == 0);
+        REQUIRE(pool.allocate(cAllocSize) == nullptr);
+
+        pool.refill();
+        REQUIRE(pool.availableCount(cAllocSize) == cBlocksCount);
+
+        // Pool is full, so released blocks wait for the refill, which gives them back to the heap.
+        auto heapFreeMemorySize = heap.getStats().freeMemorySize;
+        for (auto* ptr : ptrs)
+            pool.release(ptr, cAllocSize);
+
+        REQUIRE(pool.availableCount(cAllocSize) == cBlocksCount);
+        REQUIRE(heap.getStats().freeMemorySize == heapFreeMemorySize);
+
+        pool.refill();
+        REQUIRE(heap.getStats().freeMemorySize > heapFreeMemorySize);
+    }
+
+    SECTION("All blocks are returned to the heap")
+    {
+        REQUIRE(pool.init(cMaxSize, cBlocksCount));
+        pool.release(pool.allocate(cMaxSize), cMaxSize);
+        pool.clear();
+        REQUIRE(pool.availableCount(cMaxSize) == 0);
+        REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    }
+}
+
+#ifdef __linux__
+namespace {
+
+SignalSafePool* gPool{};
+std::atomic<std::size_t> gHandledCount{};
+std::atomic<std::size_t> gFailedCount{};
+std::atomic<void*> gKeptBlock{};
+
+constexpr std::size_t cSignalAllocSize = 64;
+
+void onAlarm(int /*unused*/)
+{
+    auto count = gHandledCount.fetch_add(1);
+    auto pattern = int(count % 256);
+    auto* ptr = static_cast<unsigned char*>(gPool->allocate(cSignalAllocSize));
+    if (ptr == nullptr)
+        return;
+
+    std::memset(ptr, pattern, cSignalAllocSize);
+    if (ptr[0] != pattern || ptr[cSignalAllocSize - 1] != pattern)
+        gFailedCount.fetch_add(1);
+
+    // Every other block outlives the handler, so that blocks are also released in later invocations.
+    if (auto* kept = gKeptBlock.exchange(ptr); kept != nullptr)
+        gPool->release(kept, cSignalAllocSize);
+}
+
+} // namespace
+
+TEST_CASE("SignalSafePool allocates inside SIGALRM handlers under load", "[unit][SignalSafePool]")
+{
+    constexpr std::size_t cPageSize = 4096;
+    constexpr std::size_t cPagesCount = 256;
+    constexpr std::size_t cBlocksCount = 32;
+    constexpr auto cDuration = std::chrono::milliseconds(300);
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    Heap heap;
+    REQUIRE(heap.init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = heap.getStats().freeMemorySize;
+
+    SignalSafePool pool(heap);
+    REQUIRE(pool.init(2 * cSignalAllocSize, cBlocksCount));
+    gPool = &pool;
+
+    struct sigaction action {};
+    struct sigaction oldAction {};
+    action.sa_handler = onAlarm;
+    sigemptyset(&action.sa_mask);
+    REQUIRE(sigaction(SIGALRM, &action, &oldAction) == 0);
+
+    itimerval timer{};
+    timer.it_interval.tv_usec = 50;
+    timer.it_value.tv_usec = 50;
+    REQUIRE(setitimer(ITIMER_REAL, &timer, nullptr) == 0);
+
+    // Normal context uses the same pool concurrently with the handlers and refills it.
+    std::size_t mainFailedCount = 0;
+    auto start = test::currentTime();
+    for (std::size_t i = 0; !test::timeElapsed(start, cDuration); ++i) {
+        std::array<unsigned char*, 4> ptrs{};
+        for (auto& ptr : ptrs) {
+            ptr = static_cast<unsigned char*>(pool.allocate(cSignalAllocSize));
+            if (ptr != nullptr)
+                std::memset(ptr, 0xa5, cSignalAllocSize);
+        }
+
+        auto* heapPtr = heap.allocate(16 + i % 512);
+        for (auto* ptr : ptrs) {
+            if (ptr != nullptr && (ptr[0] != 0xa5 || ptr[cSignalAllocSize - 1] != 0xa5))
+                ++mainFailedCount;
+
+            pool.release(ptr, cSignalAllocSize);
+        }
+
+        heap.release(heapPtr);
+        pool.refill();
+    }
+
+    timer = {};
+    REQUIRE(setitimer(ITIMER_REAL, &timer, nullptr) == 0);
+    REQUIRE(sigaction(SIGALRM, &oldAction, nullptr) == 0);
+    pool.release(gKeptBlock.exchange(nullptr), cSignalAllocSize);
+
+    REQUIRE(gHandledCount > 100);
+    REQUIRE(gFailedCount == 0);
+    REQUIRE(mainFailedCount == 0);
+
+    pool.refill();
+    REQUIRE(pool.availableCount(cSignalAllocSize) == cBlocksCount);
+    pool.clear();
+    REQUIRE(heap.getStats().freeMemorySize == freeMemorySize);
+    gPool = nullptr;
+}
+#endif
+
+} // namespace memory
@@ -0,0 +1,153 @@
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/// @file
+/// @author Kuba Sejdak
+/// @copyright BSD 2-Clause License
+///
+/// Copyright (c) 2017-2023, Kuba Sejdak <kuba.sejdak@gmail.com>
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice, this
+///    list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+/// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+/// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+/// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+/// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+/// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+/// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+/// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <TestUtils.hpp>
+#include <allocator/StlAllocator.hpp>
+#include <allocator/allocator.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace memory {
+
+TEST_CASE("StlAllocator properly allocates and releases memory", "[unit][StlAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 1024;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+    auto freeMemorySize = allocator::getStats().freeMemorySize;
+    constexpr int cElementsCount = 1000;
+
+    SECTION("Single objects")
+    {
+        StlAllocator<std::uint64_t> stlAllocator;
+        auto* ptr = stlAllocator.allocate(1);
+        REQUIRE(ptr);
+        REQUIRE(allocator::usableSize(ptr) == 2 * sizeof(std::uint64_t));
+        stlAllocator.deallocate(ptr, 1);
+
+        constexpr std::size_t cObjectsCount = 100;
+        ptr = stlAllocator.allocate(cObjectsCount);
+        REQUIRE(ptr);
+        REQUIRE(allocator::usableSize(ptr) >= cObjectsCount * sizeof(std::uint64_t));
+        stlAllocator.deallocate(ptr, cObjectsCount);
+    }
+
+    SECTION("Zero objects")
+    {
+        StlAllocator<std::uint64_t> stlAllocator;
+        auto* ptr1 = stlAllocator.allocate(0);
+        auto* ptr2 = stlAllocator.allocate(0);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        REQUIRE(ptr1 != ptr2);
+        stlAllocator.deallocate(ptr1, 0);
+        stlAllocator.deallocate(ptr2, 0);
+    }
+
+    SECTION("Objects aligned to more than the page size")
+    {
+        struct alignas(4 * cPageSize) Aligned {
+            std::uint64_t value;
+        };
+
+        StlAllocator<Aligned> stlAllocator;
+        for (std::size_t count : {std::size_t(0), std::size_t(1), std::size_t(3)}) {
+            auto* ptr = stlAllocator.allocate(count);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % alignof(Aligned) == 0);
+            stlAllocator.deallocate(ptr, count);
+        }
+    }
+
+    SECTION("std::list")
+    {
+        std::list<int, StlAllocator<int>> list;
+        for (int i = 0; i < cElementsCount; ++i)
+            list.push_back(i);
+
+        REQUIRE(allocator::getStats().freeMemorySize < freeMemorySize);
+    }
+
+    SECTION("std::map")
+    {
+        std::map<int, int, std::less<>, StlAllocator<std::pair<const int, int>>> map;
+        for (int i = 0; i < cElementsCount; ++i)
+            map.emplace(i, i);
+
+        for (int i = 0; i < cElementsCount; i += 2)
+            map.erase(i);
+
+        REQUIRE(map.size() == cElementsCount / 2);
+    }
+
+    SECTION("std::unordered_map")
+    {
+        using Pair = std::pair<const int, int>;
+        using Map = std::unordered_map<int, int, std::hash<int>, std::equal_to<>, StlAllocator<Pair>>;
+        Map map;
+        for (int i = 0; i < cElementsCount; ++i)
+            map.emplace(i, i);
+
+        REQUIRE(map.at(cElementsCount - 1) == cElementsCount - 1);
+    }
+
+    SECTION("std::vector")
+    {
+        std::vector<int, StlAllocator<int>> vector;
+        for (int i = 0; i < cElementsCount; ++i)
+            vector.push_back(i);
+
+        REQUIRE(vector.size() == cElementsCount);
+    }
+
+    SECTION("Rebound allocators are equal")
+    {
+        StlAllocator<int> intAllocator;
+        StlAllocator<double> doubleAllocator(intAllocator);
+        REQUIRE(intAllocator == doubleAllocator);
+    }
+
+    REQUIRE(allocator::getStats().freeMemorySize == freeMemorySize);
+    allocator::clear();
+}
+
+} // namespace memory
@@ -64,6 +64,7 @@ TEST_CASE("Zone is properly initialized", "[unit][Zone]")
     REQUIRE(zone.prev() == nullptr);
     REQUIRE(zone.page() == page);
     REQUIRE(zone.chunkSize() == cChunkSize);
+    REQUIRE(zone.offset() == 0);
     REQUIRE(zone.chunksCount() == (cPageSize / cChunkSize));
     REQUIRE(zone.freeChunksCount() == (cPageSize / cChunkSize));
 
@@ -79,6 +80,37 @@ TEST_CASE("Zone is properly initialized", "[unit][Zone]")
     }
 }
 
+TEST_CASE("Zone places chunks after the given offset", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 48;
+    constexpr std::size_t cOffset = 16;
+
+    zone.init(page, cPageSize, cChunkSize, cOffset);
+    REQUIRE(zone.offset() == cOffset);
+    REQUIRE(zone.chunksCount() == (cPageSize - cOffset) / cChunkSize);
+    REQUIRE(zone.freeChunksCount() == zone.chunksCount());
+
+    auto* chunk = reinterpret_cast<Chunk*>(zone.page()->address() + cOffset);
+    for (std::size_t i = 0; i < zone.chunksCount(); ++i) {
+        REQUIRE(std::uintptr_t(chunk) == zone.page()->address() + cOffset + i * cChunkSize);
+        REQUIRE(zone.isValidChunk(chunk));
+        chunk = chunk->prev();
+    }
+
+    REQUIRE(!zone.isValidChunk(reinterpret_cast<Chunk*>(zone.page()->address())));
+
+    zone.clear();
+    REQUIRE(zone.offset() == 0);
+}
+
 TEST_CASE("Zone is properly cleared", "[unit][Zone]")
 {
     Zone zone;
@@ -124,6 +156,30 @@ TEST_CASE("Zone properly allocates chunks", "[unit][Zone]")
     REQUIRE(zone.freeChunksCount() == 0);
 }
 
+TEST_CASE("Zone properly allocates chunks in bulk", "[unit][Zone]")
+{
+    constexpr std::size_t cPageSize = 256;
+    auto memory = test::alignedAlloc(cPageSize, cPageSize);
+
+    std::array<std::byte, sizeof(Page)> buffer{};
+    auto* page = reinterpret_cast<Page*>(buffer.data());
+    page->setAddress(std::uintptr_t(memory.get()));
+
+    Zone zone;
+    constexpr std::size_t cChunkSize = 32;
+    zone.init(page, cPageSize, cChunkSize);
+
+    constexpr std::size_t cChunksCount = 3;
+    std::array<void*, cChunksCount> chunks{};
+    zone.takeChunks(chunks.data(), cChunksCount);
+    REQUIRE(zone.freeChunksCount() == zone.chunksCount() - cChunksCount);
+
+    for (std::size_t i = 0; i < cChunksCount; ++i)
+        REQUIRE(std::uintptr_t(chunks.at(i)) == zone.page()->address() + cPageSize - cChunkSize * (1 + i));
+
+    REQUIRE(std::uintptr_t(zone.takeChunk()) == zone.page()->address() + cPageSize - cChunkSize * (1 + cChunksCount));
+}
+
 TEST_CASE("Zone properly deallocates chunks", "[unit][Zone]")
 {
     constexpr std::size_t cPageSize = 256;
@@ -34,10 +34,13 @@
 #include <PageAllocator.hpp>
 #include <TestUtils.hpp>
 #include <ZoneAllocator.hpp>
+#include <allocator/PageProvider.hpp>
 #include <allocator/Region.hpp>
+#include <allocator/allocator.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -45,6 +48,7 @@
 #include <cstring>
 #include <map>
 #include <utility>
+#include <vector>
 
 namespace memory {
 
@@ -181,6 +185,17 @@ TEST_CASE("Zone index is properly calculated", "[unit][ZoneAllocator]")
     }
 }
 
+TEST_CASE("Size class is equal to the zone index", "[unit][ZoneAllocator]")
+{
+    static_assert(allocator::sizeClass(1) == 0);
+    static_assert(allocator::sizeClass(ZoneAllocator::minimalAllocSize()) == 0);
+    static_assert(allocator::sizeClass(ZoneAllocator::minimalAllocSize() + 1) == 1);
+
+    constexpr std::size_t cMaxSize = 4096;
+    for (std::size_t size = 1; size <= cMaxSize; ++size)
+        REQUIRE(allocator::sizeClass(size) == detail::zoneIdx(detail::chunkSize(size)));
+}
+
 TEST_CASE("Zone allocator properly allocates user memory", "[unit][ZoneAllocator]")
 {
     constexpr std::size_t cPageSize = 256;
@@ -506,4 +521,453 @@ TEST_CASE("Zone allocator properly releases user memory", "[unit][ZoneAllocator]
     REQUIRE(stats.allocatedMemorySize == 0);
 }
 
+TEST_CASE("Zone allocator properly releases user memory with the known size", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    SECTION("Release nullptr")
+    {
+        std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+        zoneAllocator.release(nullptr, 1);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    }
+
+    SECTION("Release memory with size equal to 3 pages")
+    {
+        constexpr std::size_t cAllocSize = 3 * cPageSize;
+        std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+
+        zoneAllocator.release(ptr, cAllocSize);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    }
+
+    SECTION("Release memory served from a dedicated region")
+    {
+        constexpr std::size_t cDirectThreshold = 512 * 1024;
+        constexpr std::size_t cAllocSize = 1024 * 1024;
+        constexpr std::size_t cPoolSize = 2 * cAllocSize;
+        auto pool = test::alignedAlloc(cPageSize, cPoolSize);
+        StaticPageProvider provider(std::uintptr_t(pool.get()), std::uintptr_t(pool.get() + cPoolSize));
+        pageAllocator.setProvider(&provider, cDirectThreshold);
+
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        REQUIRE(provider.remainingSize() < cPoolSize);
+        REQUIRE(zoneAllocator.usableSize(ptr) == cAllocSize);
+
+        zoneAllocator.release(ptr, cAllocSize);
+        REQUIRE(provider.remainingSize() == cPoolSize);
+    }
+
+    SECTION("Release chunks of all sizes")
+    {
+        std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+
+        constexpr int cAllocCount = 8;
+        std::vector<std::pair<void*, std::size_t>> ptrs;
+        for (std::size_t allocSize = 1; allocSize < cPageSize; allocSize += 7) {
+            for (int i = 0; i < cAllocCount; ++i) {
+                auto* ptr = zoneAllocator.allocate(allocSize);
+                REQUIRE(ptr);
+
+                constexpr int cMemsetPattern = 0x5a;
+                std::memset(ptr, cMemsetPattern, allocSize);
+                ptrs.emplace_back(ptr, allocSize);
+            }
+        }
+
+        for (auto [ptr, allocSize] : ptrs)
+            zoneAllocator.release(ptr, allocSize);
+
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+    }
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.reservedMemorySize == 0);
+    REQUIRE(stats.freeMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator properly reallocates user memory", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+    std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    constexpr int cMemsetPattern = 0x5a;
+    auto isFilled = [](void* ptr, std::size_t size) {
+        auto* bytes = reinterpret_cast<unsigned char*>(ptr);
+        return std::all_of(bytes, bytes + size, [](unsigned char byte) { return byte == cMemsetPattern; });
+    };
+
+    SECTION("Reallocate nullptr")
+    {
+        constexpr std::size_t cAllocSize = 64;
+        auto* ptr = zoneAllocator.reallocate(nullptr, cAllocSize);
+        REQUIRE(ptr);
+        zoneAllocator.release(ptr);
+    }
+
+    SECTION("Reallocate to 0 bytes")
+    {
+        constexpr std::size_t cAllocSize = 64;
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        REQUIRE(zoneAllocator.reallocate(ptr, 0) == nullptr);
+    }
+
+    SECTION("Reallocate invalid pointer")
+    {
+        constexpr unsigned int cPattern = 0xdeadbeef;
+        REQUIRE(zoneAllocator.reallocate(reinterpret_cast<void*>(cPattern), 1) == nullptr);
+    }
+
+    SECTION("Chunk stays in place within the same chunk size")
+    {
+        constexpr std::size_t cAllocSize1 = 40;
+        constexpr std::size_t cAllocSize2 = 64;
+        auto* ptr = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr);
+        REQUIRE(zoneAllocator.reallocate(ptr, cAllocSize2) == ptr);
+        zoneAllocator.release(ptr, cAllocSize2);
+    }
+
+    SECTION("Chunk is moved to the bigger chunk size")
+    {
+        constexpr std::size_t cAllocSize1 = 40;
+        constexpr std::size_t cAllocSize2 = 100;
+        auto* ptr1 = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr1);
+        std::memset(ptr1, cMemsetPattern, cAllocSize1);
+
+        auto* ptr2 = zoneAllocator.reallocate(ptr1, cAllocSize2);
+        REQUIRE(ptr2);
+        REQUIRE(ptr2 != ptr1);
+        REQUIRE(isFilled(ptr2, cAllocSize1));
+        zoneAllocator.release(ptr2, cAllocSize2);
+    }
+
+    SECTION("Chunk is moved to the pages")
+    {
+        constexpr std::size_t cAllocSize1 = 100;
+        constexpr std::size_t cAllocSize2 = 3 * cPageSize;
+        auto* ptr1 = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr1);
+        std::memset(ptr1, cMemsetPattern, cAllocSize1);
+
+        auto* ptr2 = zoneAllocator.reallocate(ptr1, cAllocSize2);
+        REQUIRE(ptr2);
+        REQUIRE(isFilled(ptr2, cAllocSize1));
+        zoneAllocator.release(ptr2, cAllocSize2);
+    }
+
+    SECTION("Pages grow and shrink in place")
+    {
+        constexpr std::size_t cAllocSize1 = 3 * cPageSize;
+        constexpr std::size_t cAllocSize2 = 10 * cPageSize;
+        constexpr std::size_t cAllocSize3 = cPageSize + 1;
+        auto* ptr = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr);
+        std::memset(ptr, cMemsetPattern, cAllocSize1);
+
+        REQUIRE(zoneAllocator.reallocate(ptr, cAllocSize2) == ptr);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - cAllocSize2 / cPageSize);
+        REQUIRE(isFilled(ptr, cAllocSize1));
+        std::memset(ptr, cMemsetPattern, cAllocSize2);
+
+        REQUIRE(zoneAllocator.reallocate(ptr, cAllocSize3) == ptr);
+        REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount - (cAllocSize3 + cPageSize - 1) / cPageSize);
+        REQUIRE(isFilled(ptr, cAllocSize3));
+        zoneAllocator.release(ptr, cAllocSize3);
+    }
+
+    SECTION("Pages are moved when the following pages are used")
+    {
+        constexpr std::size_t cAllocSize1 = 3 * cPageSize;
+        constexpr std::size_t cAllocSize2 = 5 * cPageSize;
+        auto* ptr1 = zoneAllocator.allocate(cAllocSize1);
+        auto* ptr2 = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr1);
+        REQUIRE(ptr2);
+        std::memset(ptr1, cMemsetPattern, cAllocSize1);
+
+        auto* ptr3 = zoneAllocator.reallocate(ptr1, cAllocSize2);
+        REQUIRE(ptr3);
+        REQUIRE(ptr3 != ptr1);
+        REQUIRE(isFilled(ptr3, cAllocSize1));
+        zoneAllocator.release(ptr2);
+        zoneAllocator.release(ptr3);
+    }
+
+    SECTION("Pages are moved to the chunk")
+    {
+        constexpr std::size_t cAllocSize1 = 3 * cPageSize;
+        constexpr std::size_t cAllocSize2 = 16;
+        auto* ptr1 = zoneAllocator.allocate(cAllocSize1);
+        REQUIRE(ptr1);
+        std::memset(ptr1, cMemsetPattern, cAllocSize1);
+
+        auto* ptr2 = zoneAllocator.reallocate(ptr1, cAllocSize2);
+        REQUIRE(ptr2);
+        REQUIRE(isFilled(ptr2, cAllocSize2));
+        zoneAllocator.release(ptr2, cAllocSize2);
+    }
+
+    SECTION("Reallocation fails when no pages are available")
+    {
+        constexpr std::size_t cAllocSize = 3 * cPageSize;
+        auto* ptr = zoneAllocator.allocate(cAllocSize);
+        REQUIRE(ptr);
+        std::memset(ptr, cMemsetPattern, cAllocSize);
+
+        REQUIRE(zoneAllocator.reallocate(ptr, size) == nullptr);
+        REQUIRE(isFilled(ptr, cAllocSize));
+        zoneAllocator.release(ptr);
+    }
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator properly allocates zeroed user memory", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    REQUIRE(zoneAllocator.allocateZeroed(0) == nullptr);
+
+    for (std::size_t allocSize : {std::size_t(1), std::size_t(60), cPageSize - 1, 3 * cPageSize + 1}) {
+        constexpr int cMemsetPattern = 0x5a;
+        auto* ptr1 = zoneAllocator.allocate(allocSize);
+        REQUIRE(ptr1);
+        std::memset(ptr1, cMemsetPattern, allocSize);
+        zoneAllocator.release(ptr1);
+
+        auto* ptr2 = reinterpret_cast<unsigned char*>(zoneAllocator.allocateZeroed(allocSize));
+        REQUIRE(ptr2);
+        REQUIRE(std::all_of(ptr2, ptr2 + allocSize, [](unsigned char byte) { return byte == 0; }));
+        zoneAllocator.release(ptr2);
+    }
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator properly allocates and releases user memory in batches", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+    std::size_t freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    constexpr std::size_t cBatchSize = 100;
+    std::array<void*, cBatchSize> ptrs{};
+
+    SECTION("Allocate 0 bytes")
+    {
+        REQUIRE(!zoneAllocator.allocateBatch(0, ptrs.data(), cBatchSize));
+    }
+
+    SECTION("Allocate and release empty batch")
+    {
+        constexpr std::size_t cAllocSize = 16;
+        REQUIRE(zoneAllocator.allocateBatch(cAllocSize, ptrs.data(), 0));
+        zoneAllocator.releaseBatch(ptrs.data(), 0);
+    }
+
+    SECTION("Allocate and release batches of all sizes")
+    {
+        for (std::size_t allocSize = 1; allocSize <= 2 * cPageSize; allocSize += 13) {
+            REQUIRE(zoneAllocator.allocateBatch(allocSize, ptrs.data(), cBatchSize));
+
+            for (void* ptr : ptrs) {
+                REQUIRE(ptr);
+
+                constexpr int cMemsetPattern = 0x5a;
+                std::memset(ptr, cMemsetPattern, allocSize);
+            }
+
+            std::sort(ptrs.begin(), ptrs.end());
+            REQUIRE(std::adjacent_find(ptrs.begin(), ptrs.end()) == ptrs.end());
+
+            zoneAllocator.releaseBatch(ptrs.data(), cBatchSize);
+            REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+        }
+    }
+
+    SECTION("Release batch with nullptr entries")
+    {
+        constexpr std::size_t cAllocSize = 64;
+        REQUIRE(zoneAllocator.allocateBatch(cAllocSize, ptrs.data(), cBatchSize / 2));
+        zoneAllocator.releaseBatch(ptrs.data(), cBatchSize);
+    }
+
+    SECTION("Batch is not allocated when there is not enough memory")
+    {
+        constexpr std::size_t cAllocSize = 4 * cPageSize;
+        REQUIRE(!zoneAllocator.allocateBatch(cAllocSize, ptrs.data(), cBatchSize));
+    }
+
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator properly reports usable size of user memory", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+
+    REQUIRE(zoneAllocator.usableSize(nullptr) == 0);
+    REQUIRE(zoneAllocator.allocationSize(0) == 0);
+
+    constexpr unsigned int cPattern = 0xdeadbeef;
+    REQUIRE(zoneAllocator.usableSize(reinterpret_cast<void*>(cPattern)) == 0);
+
+    std::map<std::size_t, std::size_t> sizes = {
+        {1,                 16           },
+        {16,                16           },
+        {17,                32           },
+        {134,               256          },
+        {cPageSize - 1,     cPageSize    },
+        {cPageSize,         cPageSize    },
+        {3 * cPageSize + 1, 4 * cPageSize}
+    };
+
+    for (const auto& [allocSize, usableSize] : sizes) {
+        auto* ptr = zoneAllocator.allocate(allocSize);
+        REQUIRE(ptr);
+        REQUIRE(zoneAllocator.allocationSize(allocSize) == usableSize);
+        REQUIRE(zoneAllocator.usableSize(ptr) == usableSize);
+
+        constexpr int cMemsetPattern = 0x5a;
+        std::memset(ptr, cMemsetPattern, usableSize);
+        zoneAllocator.release(ptr, usableSize);
+    }
+
+    auto stats = zoneAllocator.getStats();
+    REQUIRE(stats.usedMemorySize == cPageSize);
+    REQUIRE(stats.allocatedMemorySize == 0);
+}
+
+TEST_CASE("Zone allocator properly allocates user memory from size classes", "[unit][ZoneAllocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 256;
+    PageAllocator pageAllocator;
+
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+
+    constexpr int cRegionsCount = 2;
+    std::array<Region, cRegionsCount> regions = {
+        {{std::uintptr_t(memory.get()), size}, {0, 0}}
+    };
+
+    REQUIRE(pageAllocator.init(regions.data(), cPageSize));
+
+    ZoneAllocator zoneAllocator;
+    REQUIRE(zoneAllocator.init(&pageAllocator, cPageSize));
+    auto freePagesCount = pageAllocator.getStats().freePagesCount;
+
+    constexpr std::size_t cSizeClassesCount = 6;
+    constexpr int cAllocationsCount = 20;
+    std::vector<void*> ptrs;
+    for (std::size_t idx = 0; idx < cSizeClassesCount; ++idx) {
+        auto chunkSize = detail::zoneChunkSize(idx);
+        for (int i = 0; i < cAllocationsCount; ++i) {
+            auto* ptr = zoneAllocator.allocateSizeClass(idx);
+            REQUIRE(ptr);
+            REQUIRE(std::uintptr_t(ptr) % std::min(chunkSize, cPageSize) == 0);
+            REQUIRE(zoneAllocator.usableSize(ptr) == chunkSize);
+            ptrs.push_back(ptr);
+        }
+    }
+
+    for (std::size_t i = 0; i < ptrs.size(); ++i)
+        zoneAllocator.releaseSizeClass(ptrs[i], i / cAllocationsCount);
+
+    zoneAllocator.releaseSizeClass(nullptr, 0);
+    REQUIRE(pageAllocator.getStats().freePagesCount == freePagesCount);
+}
+
 } // namespace memory
@@ -41,6 +41,7 @@
 #include <cstring>
 #include <random>
 #include <regex>
+#include <utility>
 
 namespace memory {
 
@@ -201,4 +202,83 @@ TEST_CASE("Allocator properly allocates and releases user memory", "[unit][alloc
     }
 }
 
+TEST_CASE("Allocator properly releases user memory with the known size", "[unit][allocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 535;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    constexpr int cAllocationsCount = 100;
+    constexpr int cIterationsCount = 100;
+    constexpr int cMaxAllocPagesCount = 4;
+    auto maxAllocSize = cMaxAllocPagesCount * cPageSize;
+
+    // Initialize random number generator.
+    std::random_device randomDevice;
+    std::mt19937 randomGenerator(randomDevice());
+    std::uniform_int_distribution<std::size_t> distribution(1, maxAllocSize);
+
+    std::array<std::pair<void*, std::size_t>, cAllocationsCount> ptrs{};
+
+    for (int i = 0; i < cIterationsCount; ++i) {
+        ptrs.fill({nullptr, 0});
+
+        // Allocate memory.
+        for (auto& [ptr, allocSize] : ptrs) {
+            allocSize = distribution(randomGenerator);
+            ptr = allocator::allocate(allocSize);
+
+            if (ptr != nullptr) {
+                constexpr int cMemsetPattern = 0x5a;
+                std::memset(ptr, cMemsetPattern, allocSize);
+            }
+        }
+
+        // Release memory.
+        for (auto& [ptr, allocSize] : ptrs)
+            allocator::release(ptr, allocSize);
+
+        auto stats = allocator::getStats();
+        REQUIRE(stats.allocatedMemorySize == 0);
+        REQUIRE(stats.freeMemorySize == stats.userMemorySize);
+    }
+}
+
+TEST_CASE("Allocator reports the real size of user memory", "[unit][allocator]")
+{
+    constexpr std::size_t cPageSize = 256;
+    constexpr std::size_t cPagesCount = 535;
+    auto size = cPageSize * cPagesCount;
+    auto memory = test::alignedAlloc(cPageSize, size);
+    REQUIRE(allocator::init(std::uintptr_t(memory.get()), std::uintptr_t(memory.get() + size), cPageSize));
+
+    SECTION("Allocate 0 bytes")
+    {
+        auto result = allocator::allocateAtLeast(0);
+        REQUIRE(result.ptr == nullptr);
+        REQUIRE(result.size == 0);
+    }
+
+    SECTION("Allocate 134 bytes")
+    {
+        constexpr std::size_t cAllocSize = 134;
+        auto result = allocator::allocateAtLeast(cAllocSize);
+        REQUIRE(result.ptr);
+        REQUIRE(result.size == cPageSize);
+        REQUIRE(allocator::usableSize(result.ptr) == result.size);
+        allocator::release(result.ptr, result.size);
+    }
+
+    SECTION("Allocate more than the free memory")
+    {
+        auto result = allocator::allocateAtLeast(size);
+        REQUIRE(result.ptr == nullptr);
+        REQUIRE(result.size == 0);
+    }
+
+    REQUIRE(allocator::getStats().allocatedMemorySize == 0);
+}
+
 } // namespace memory
@@ -38,6 +38,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <limits>
 
 namespace memory {
 
@@ -70,6 +71,73 @@ TEST_CASE("Values are correctly rounded to the closest power of 2", "[unit][util
     }
 }
 
+TEST_CASE("Values are correctly rounded to the closest multiple of alignment", "[unit][utils]")
+{
+    constexpr std::size_t cMaxAlignment = 4096;
+    constexpr std::size_t cIterations = 10000;
+    for (std::size_t alignment = 1; alignment <= cMaxAlignment; alignment *= 2) {
+        for (std::size_t i = 0; i < cIterations; ++i) {
+            auto value = utils::roundUp(i, alignment);
+            REQUIRE(value >= i);
+            REQUIRE(value % alignment == 0);
+            REQUIRE(value - i < alignment);
+        }
+    }
+}
+
+TEST_CASE("Values are correctly rounded down to the closest multiple of alignment", "[unit][utils]")
+{
+    constexpr std::size_t cMaxAlignment = 4096;
+    constexpr std::size_t cIterations = 10000;
+    for (std::size_t alignment = 1; alignment <= cMaxAlignment; alignment *= 2) {
+        for (std::size_t i = 0; i < cIterations; ++i) {
+            auto value = utils::roundDown(i, alignment);
+            REQUIRE(value <= i);
+            REQUIRE(value % alignment == 0);
+            REQUIRE(i - value < alignment);
+        }
+    }
+}
+
+TEST_CASE("Integer part of the base 2 logarithm is correctly calculated", "[unit][utils]")
+{
+    static_assert(utils::log2(1) == 0);
+    static_assert(utils::log2(2) == 1);
+    static_assert(utils::log2(3) == 1);
+    static_assert(utils::log2(4096) == 12);
+
+    // Result changes only at the powers of 2, so it is checked around each of them.
+    constexpr std::size_t cMaxIdx = std::numeric_limits<std::size_t>::digits - 1;
+    for (std::size_t idx = 1; idx <= cMaxIdx; ++idx) {
+        auto value = std::size_t(1) << idx;
+        REQUIRE(utils::log2(value - 1) == idx - 1);
+        REQUIRE(utils::log2(value) == idx);
+        REQUIRE(utils::log2(value + 1) == idx);
+    }
+
+    REQUIRE(utils::log2(std::numeric_limits<std::size_t>::max()) == cMaxIdx);
+}
+
+TEST_CASE("Values are correctly divided with rounding up", "[unit][utils]")
+{
+    static_assert(utils::divRoundUp(0, 256) == 0);
+    static_assert(utils::divRoundUp(1, 256) == 1);
+    static_assert(utils::divRoundUp(256, 256) == 1);
+    static_assert(utils::divRoundUp(257, 256) == 2);
+
+    // Result changes only at the multiples of the divisor, so it is checked around them and at the maximal value.
+    constexpr std::size_t cMaxDivisor = 4096;
+    constexpr auto cMaxValue = std::numeric_limits<std::size_t>::max();
+    for (std::size_t divisor = 1; divisor <= cMaxDivisor; divisor *= 2) {
+        REQUIRE(utils::divRoundUp(0, divisor) == 0);
+        REQUIRE(utils::divRoundUp(1, divisor) == 1);
+        REQUIRE(utils::divRoundUp(divisor - 1, divisor) == (divisor == 1 ? 0 : 1));
+        REQUIRE(utils::divRoundUp(divisor, divisor) == 1);
+        REQUIRE(utils::divRoundUp(divisor + 1, divisor) == 2);
+        REQUIRE(utils::divRoundUp(cMaxValue, divisor) == cMaxValue / divisor + (divisor == 1 ? 0 : 1));
+    }
+}
+
 TEST_CASE("Pointers are correctly moved", "[unit][utils]")
 {
     constexpr int cMemorySize = 64;